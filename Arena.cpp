@@ -0,0 +1,34 @@
+#include "Arena.h"
+
+#include <cstdint>
+
+constexpr size_t Arena::DEFAULT_CHUNK_SIZE;
+
+Arena::Arena(size_t chunkSize)
+    : chunkSize(chunkSize), current(nullptr), remaining(0), allocated(0) {}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    size_t padding =
+        (alignment - reinterpret_cast<uintptr_t>(current) % alignment) %
+        alignment;
+
+    if (current == nullptr || padding + size > remaining) {
+        // oversized requests get a chunk of their own
+        size_t reserved = size + alignment > chunkSize
+            ? size + alignment : chunkSize;
+        chunks.emplace_back(new char[reserved]);
+        current = chunks.back().get();
+        remaining = reserved;
+        padding = (alignment - reinterpret_cast<uintptr_t>(current) %
+            alignment) % alignment;
+    }
+
+    void* memory = current + padding;
+    current += padding + size;
+    remaining -= padding + size;
+    allocated += size;
+
+    return memory;
+}
+
+size_t Arena::bytesAllocated() const { return allocated; }
@@ -0,0 +1,98 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+using std::shared_ptr;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * @note
+ * A bump allocator owned by one game. Allocations are carved out of large
+ * chunks and never freed individually, the chunks are released together when
+ * the last object allocated from the arena is gone. Everything allocated is
+ * kept until then, even once it is no longer used, so the arena only holds
+ * what a game sets up once: its tiles and the first bag, hands and board.
+ * The copies made for snapshots come from the heap and are freed as soon as
+ * they are dropped. An arena is not thread-safe and must only be allocated
+ * from by the game's thread.
+ */
+class Arena {
+public:
+    /**
+     * Construct an empty arena that grows in chunks of the given size.
+     *
+     * @param chunkSize - the number of bytes reserved at a time
+     */
+    explicit Arena(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * Allocate uninitialised memory from the current chunk.
+     *
+     * @param size - the number of bytes
+     * @param alignment - the required alignment, a power of two
+     * @return a pointer to the memory
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * Get the number of bytes handed out so far.
+     */
+    size_t bytesAllocated() const;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+private:
+    const size_t chunkSize;
+    vector<unique_ptr<char[]>> chunks;
+    char* current;
+    size_t remaining;
+    size_t allocated;
+};
+
+/**
+ * A standard allocator drawing from an arena, for use with allocate_shared and
+ * containers. Without an arena it falls back to the global heap.
+ */
+template <class T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(const shared_ptr<Arena>& arena) : arena(arena) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        if (!arena)
+            return static_cast<T*>(::operator new(count * sizeof(T)));
+
+        return static_cast<T*>(
+            arena->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // memory from the arena is only released with the arena itself
+    void deallocate(T* pointer, size_t count) {
+        if (!arena)
+            ::operator delete(pointer);
+    }
+
+    template <class U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+
+    template <class U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+
+    shared_ptr<Arena> arena;
+};
+
+#endif // !ARENA_H
@@ -0,0 +1,190 @@
+#include "AutoSaver.h"
+#include "Stats.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::endl;
+using std::lock_guard;
+using std::ostringstream;
+using std::unique_lock;
+
+AutoSaver::AutoSaver(const string& fileName, size_t interval, bool deltas)
+    : fileName(fileName), interval(interval), deltas(deltas),
+      movesSinceSave(0), pending(nullptr), stopping(false),
+      writer(&AutoSaver::run, this) {}
+
+AutoSaver::AutoSaver() : AutoSaver("", 0) {}
+
+AutoSaver::~AutoSaver() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+
+    queued.notify_one();
+    writer.join();
+}
+
+void AutoSaver::moveMade(GameManager& game, const string& move) {
+    if (interval == 0)
+        return;
+
+    bool based = false;
+    if (deltas) {
+        lock_guard<mutex> guard(lock);
+        based = base.lock() == game.arena;
+    }
+
+    if (++movesSinceSave >= interval || (deltas && !based)) {
+        movesSinceSave = 0;
+        if (deltas) {
+            lock_guard<mutex> guard(lock);
+            base = game.arena;
+        }
+        save(game.snapshot());
+    } else if (deltas) {
+        {
+            lock_guard<mutex> guard(lock);
+            pendingDeltas.push_back(move);
+        }
+        queued.notify_one();
+    }
+}
+
+void AutoSaver::save(const shared_ptr<const GameSnapshot>& snapshot) {
+    {
+        lock_guard<mutex> guard(lock);
+        pending = snapshot;
+        pendingDeltas.clear();
+    }
+
+    queued.notify_one();
+}
+
+void AutoSaver::saveAs(const string& fileName,
+    const shared_ptr<const GameSnapshot>& snapshot,
+    const function<void(bool)>& done) {
+    {
+        lock_guard<mutex> guard(lock);
+        pendingNamed.push_back({fileName, snapshot, done});
+    }
+
+    queued.notify_one();
+}
+
+void AutoSaver::run() {
+    // whether the file holds every move up to the last delta written
+    bool chained = true;
+    unique_lock<mutex> guard(lock);
+    while (!stopping || pending || !pendingDeltas.empty() ||
+           !pendingNamed.empty()) {
+        queued.wait(guard, [this] {
+            return stopping || pending || !pendingDeltas.empty() ||
+                !pendingNamed.empty();
+        });
+
+        shared_ptr<const GameSnapshot> snapshot = pending;
+        pending.reset();
+        vector<string> moves;
+        moves.swap(pendingDeltas);
+        vector<NamedSave> named;
+        named.swap(pendingNamed);
+        if (!snapshot && moves.empty() && named.empty())
+            continue;
+
+        // serialise and write without holding the lock
+        guard.unlock();
+        for (NamedSave& save : named) {
+            STATS_TIME(TIMER_AUTOSAVE);
+            ostringstream contents;
+            contents << *save.snapshot;
+            save.snapshot.reset();
+            save.done(write(save.fileName, contents.str()));
+        }
+        named.clear();
+        if (!snapshot && moves.empty()) {
+            guard.lock();
+            continue;
+        }
+
+        STATS_TIME(TIMER_AUTOSAVE);
+        bool written = true;
+        if (snapshot) {
+            ostringstream contents;
+            contents << *snapshot;
+            snapshot.reset();
+            written = write(fileName, contents.str());
+            chained = written;
+        }
+
+        // a delta is only appended after every move before it, otherwise
+        // it waits for the next save in full
+        if (chained && !moves.empty()) {
+            string contents;
+            for (const string& move : moves)
+                contents += move + '\n';
+            written = append(contents);
+            chained = written;
+        }
+
+        if (!written)
+            cerr << "Autosave to " << fileName << " failed." << endl;
+        STATS_STOP();
+        guard.lock();
+
+        if (!chained)
+            base.reset();
+    }
+}
+
+bool AutoSaver::write(const string& fileName, const string& contents) {
+    string tempName = fileName + ".tmp";
+    int fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool written = fd >= 0;
+
+    size_t offset = 0;
+    while (written && offset < contents.size()) {
+        ssize_t count = ::write(
+            fd, contents.data() + offset, contents.size() - offset);
+        written = count > 0;
+        if (written)
+            offset += count;
+    }
+
+    // the data must reach the disk before the rename makes it visible
+    written = written && fsync(fd) == 0;
+    if (fd >= 0)
+        written = close(fd) == 0 && written;
+    written = written && std::rename(tempName.c_str(), fileName.c_str()) == 0;
+
+    if (!written)
+        std::remove(tempName.c_str());
+
+    return written;
+}
+
+bool AutoSaver::append(const string& contents) const {
+    int fd = open(fileName.c_str(), O_WRONLY | O_APPEND);
+    bool written = fd >= 0;
+
+    size_t offset = 0;
+    while (written && offset < contents.size()) {
+        ssize_t count = ::write(
+            fd, contents.data() + offset, contents.size() - offset);
+        written = count > 0;
+        if (written)
+            offset += count;
+    }
+
+    written = written && fsync(fd) == 0;
+    if (fd >= 0)
+        written = close(fd) == 0 && written;
+
+    return written;
+}
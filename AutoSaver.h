@@ -0,0 +1,140 @@
+#ifndef AUTO_SAVER_H
+#define AUTO_SAVER_H
+
+#include "GameManager.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::condition_variable;
+using std::function;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::vector;
+
+/**
+ * @note
+ * Saves the game every few moves on a background writer thread. The game
+ * thread only takes a snapshot and hands it over, the writer serialises it,
+ * writes it to a temporary file, syncs it to disk and renames it over the
+ * save file so a crash never leaves a partially written save behind.
+ *
+ * With deltas on, the save in full is the base of the file, and each move
+ * after it is appended as a line of its own, the tile and location of a
+ * placement such as R4@B5 or the tile of a replacement such as R4, so a
+ * move costs the size of the move rather than of the game. The interval
+ * then sets how often the file is compacted by saving in full again.
+ *
+ * Saves to files of their own can be queued too, each written once and then
+ * reported to a callback on the writer thread, so a server can save games
+ * without blocking the loop that serves them.
+ */
+class AutoSaver {
+public:
+    /**
+     * Construct an autosaver and start its writer thread.
+     *
+     * @param fileName - the name of the save file
+     * @param interval - the number of moves between saves in full
+     * @param deltas - whether to append each move in between
+     */
+    AutoSaver(const string& fileName, size_t interval, bool deltas = false);
+
+    /**
+     * Construct an autosaver with no save file of its own, which only writes
+     * the saves queued with saveAs.
+     */
+    AutoSaver();
+
+    /**
+     * Destructor to write any pending snapshot and stop the writer thread.
+     */
+    ~AutoSaver();
+
+    /**
+     * Count a completed move, queueing a save once the interval is reached,
+     * or the move itself if deltas are on and the file has a base for the
+     * game.
+     *
+     * @param game - the game the move was made in
+     * @param move - the move as a delta, tile@location or tile
+     */
+    void moveMade(GameManager& game, const string& move);
+
+    /**
+     * Queue a snapshot to be saved, replacing any snapshot not yet written
+     * and any delta queued before it.
+     *
+     * @param snapshot - the snapshot to be saved
+     */
+    void save(const shared_ptr<const GameSnapshot>& snapshot);
+
+    /**
+     * Queue a snapshot to be saved to a file of its own, after the saves
+     * to other files queued before it.
+     *
+     * @param fileName - the name of the file, replaced if it exists
+     * @param snapshot - the snapshot to be saved
+     * @param done - called on the writer thread with whether the file was
+     * written
+     */
+    void saveAs(const string& fileName,
+        const shared_ptr<const GameSnapshot>& snapshot,
+        const function<void(bool)>& done);
+
+private:
+    /**
+     * A save to a file other than the autosaver's own.
+     */
+    struct NamedSave {
+        string fileName;
+        shared_ptr<const GameSnapshot> snapshot;
+        function<void(bool)> done;
+    };
+
+    /**
+     * The writer thread loop, waits for and writes queued snapshots and
+     * deltas.
+     */
+    void run();
+
+    /**
+     * Atomically replace a save file with the given contents.
+     *
+     * @param fileName - the name of the file
+     * @param contents - the serialised game
+     * @return true if the file was written and renamed
+     */
+    static bool write(const string& fileName, const string& contents);
+
+    /**
+     * Append deltas to the save file and sync them to disk.
+     *
+     * @param contents - the deltas, a line each
+     * @return true if every byte was written
+     */
+    bool append(const string& contents) const;
+
+    const string fileName;
+    const size_t interval;
+    const bool deltas;
+    size_t movesSinceSave;
+    shared_ptr<const GameSnapshot> pending;
+    vector<string> pendingDeltas;
+    vector<NamedSave> pendingNamed;
+
+    // the arena of the game the file's base was saved from, reset if a
+    // write fails so the next move saves in full again
+    weak_ptr<Arena> base;
+    bool stopping;
+    mutex lock;
+    condition_variable queued;
+    thread writer;
+};
+
+#endif // !AUTO_SAVER_H
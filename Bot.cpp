@@ -0,0 +1,139 @@
+#include "Bot.h"
+#include "EndgameSolver.h"
+#include "MoveSearch.h"
+
+#include <stdexcept>
+
+using std::invalid_argument;
+using std::make_unique;
+using std::uniform_int_distribution;
+
+unique_ptr<Bot> Bot::create(const string& config,
+    shared_ptr<const OpeningBook> book) {
+    const string search = "search:";
+    unique_ptr<Bot> bot;
+    if (config == "random") {
+        bot = make_unique<RandomBot>();
+    } else if (config == "greedy") {
+        bot = make_unique<GreedyBot>();
+    } else if (config.compare(0, search.size(), search) == 0 &&
+               config.size() > search.size() &&
+               config.find_first_not_of("0123456789", search.size()) ==
+                   string::npos) {
+        bot = make_unique<SearchBot>(std::chrono::milliseconds(
+            std::stoul(config.substr(search.size()))), book);
+    } else {
+        throw invalid_argument("unknown bot: " + config);
+    }
+
+    return bot;
+}
+
+vector<BotMove> Bot::placements(const GameManager& game) {
+    typedef LineIndex<StandardRules>::KindMask KindMask;
+    const LineIndex<StandardRules>& index = game.board->getIndex();
+    KindMask hand = game.currentPlayer->getHand()->getKindMask();
+    vector<BotMove> moves;
+
+    if (index.getTileCount() == 0) {
+        for (size_t kind = 0; kind < StandardRules::KINDS; ++kind) {
+            if (hand & (KindMask(1) << kind)) {
+                moves.push_back({false, kind, StandardRules::BOARD_LENGTH / 2,
+                    StandardRules::BOARD_LENGTH / 2});
+            }
+        }
+    }
+
+    for (size_t i = 0; i < index.getFrontierSize(); ++i) {
+        size_t row = index.getFrontierCell(i) / StandardRules::BOARD_LENGTH;
+        size_t column =
+            index.getFrontierCell(i) % StandardRules::BOARD_LENGTH;
+        KindMask accepted = index.fit(row, column, hand).kinds;
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if (accepted & 1)
+                moves.push_back({false, kind, row, column});
+        }
+    }
+
+    return moves;
+}
+
+BotMove Bot::replaceAny(const GameManager& game, mt19937_64& random) {
+    shared_ptr<const TileList> hand =
+        game.currentPlayer->getHand()->getTiles();
+    uniform_int_distribution<size_t> pick(0, hand->size() - 1);
+    TileList::const_iterator tile = hand->begin();
+    for (size_t i = pick(random); i > 0; --i)
+        ++tile;
+
+    return {true, StandardRules::kindOf(**tile), 0, 0};
+}
+
+BotMove RandomBot::choose(GameManager& game, mt19937_64& random) {
+    vector<BotMove> moves = placements(game);
+    if (moves.empty())
+        return replaceAny(game, random);
+
+    uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+    return moves[pick(random)];
+}
+
+BotMove GreedyBot::choose(GameManager& game, mt19937_64& random) {
+    vector<BotMove> moves = placements(game);
+    if (moves.empty())
+        return replaceAny(game, random);
+
+    // keep the best moves at the front, then pick one of them; the moves
+    // in a cell come together and all score the same
+    const LineIndex<StandardRules>& index = game.board->getIndex();
+    LineIndex<StandardRules>::KindMask hand =
+        game.currentPlayer->getHand()->getKindMask();
+    size_t best = 0;
+    size_t bestPoints = 0;
+    size_t points = 0;
+    size_t cell = StandardRules::CELLS;
+    for (const BotMove& move : moves) {
+        if (move.row * StandardRules::BOARD_LENGTH + move.column != cell) {
+            cell = move.row * StandardRules::BOARD_LENGTH + move.column;
+            points = index.fit(move.row, move.column, hand).points;
+        }
+        if (points > bestPoints) {
+            best = 0;
+            bestPoints = points;
+        }
+        if (points == bestPoints)
+            moves[best++] = move;
+    }
+
+    uniform_int_distribution<size_t> pick(0, best - 1);
+    return moves[pick(random)];
+}
+
+SearchBot::SearchBot(std::chrono::milliseconds budget,
+    shared_ptr<const OpeningBook> book) : budget(budget), book(book) {}
+
+BotMove SearchBot::choose(GameManager& game, mt19937_64& random) {
+    BookMove known;
+    if (book && book->lookup(game, known))
+        return {false, known.kind, known.row, known.column};
+
+    // with the bag empty the rest of the game can be searched exactly
+    if (game.bag->getTiles()->isEmpty()) {
+        EndgameSolver<StandardRules> solver(*game.snapshot());
+        EndgameResult result = solver.solve(budget);
+        if (result.line.empty() ||
+            result.line.front().kind == LineIndex<StandardRules>::NO_TILE)
+            return replaceAny(game, random);
+
+        const EndgameMove& best = result.line.front();
+        return {false, best.kind, best.row, best.column};
+    }
+
+    MoveSearch<StandardRules> search(*game.snapshot());
+    SearchResult result = search.search(budget, 1, 1);
+    if (result.candidates.empty())
+        return replaceAny(game, random);
+
+    const Candidate& best = result.candidates.front();
+    return {false, best.kind, best.row, best.column};
+}
@@ -0,0 +1,118 @@
+#ifndef BOT_H
+#define BOT_H
+
+#include "GameManager.h"
+#include "OpeningBook.h"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using std::mt19937_64;
+using std::shared_ptr;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * A move chosen by a bot, a placement or a tile to replace.
+ */
+struct BotMove {
+    bool replace;
+    size_t kind;
+    size_t row;
+    size_t column;
+};
+
+/**
+ * @note
+ * A strategy for playing the standard game without a person, chosen by a
+ * configuration such as "greedy" or "search:5". A bot only decides, the
+ * caller makes the move, and its randomness comes from the generator it is
+ * given so games can be replayed from a seed.
+ */
+class Bot {
+public:
+    virtual ~Bot() = default;
+
+    /**
+     * Create a bot from its configuration.
+     *
+     *   random      places a random legal tile
+     *   greedy      places the tile that scores the most now
+     *   search:<ms> places MoveSearch's best tile within a budget per move,
+     *               or the book's while the position is in it
+     *
+     * @param config - the configuration
+     * @param book - an opening book for the bots that search, or nullptr
+     * @return the bot
+     * @throws invalid_argument if the configuration is not recognised
+     */
+    static unique_ptr<Bot> create(const string& config,
+        shared_ptr<const OpeningBook> book = nullptr);
+
+    /**
+     * Choose a move for the current player. A bot only replaces a tile when
+     * no tile in hand can be placed, the caller has to pass instead if the
+     * bag is empty.
+     *
+     * @param game - the game, which is not changed
+     * @param random - the generator for any random choice
+     * @return the move
+     */
+    virtual BotMove choose(GameManager& game, mt19937_64& random) = 0;
+
+protected:
+    /**
+     * Get every legal placement of a tile in the current player's hand, the
+     * first tile goes in the centre of the board.
+     */
+    static vector<BotMove> placements(const GameManager& game);
+
+    /**
+     * Choose a random tile from the current player's hand to replace.
+     */
+    static BotMove replaceAny(const GameManager& game, mt19937_64& random);
+};
+
+/**
+ * Places a tile chosen uniformly from the legal placements.
+ */
+class RandomBot : public Bot {
+public:
+    BotMove choose(GameManager& game, mt19937_64& random) override;
+};
+
+/**
+ * Places the tile that scores the most points now, breaking ties at random.
+ */
+class GreedyBot : public Bot {
+public:
+    BotMove choose(GameManager& game, mt19937_64& random) override;
+};
+
+/**
+ * Places the best tile MoveSearch finds within a time budget, on the
+ * caller's thread alone, unless the opening book has the position. Once the
+ * bag is empty, EndgameSolver searches the rest of the game instead.
+ */
+class SearchBot : public Bot {
+public:
+    /**
+     * @param budget - the time allowed for each move
+     * @param book - the opening book, or nullptr
+     */
+    SearchBot(std::chrono::milliseconds budget,
+        shared_ptr<const OpeningBook> book);
+
+    BotMove choose(GameManager& game, mt19937_64& random) override;
+
+private:
+    const std::chrono::milliseconds budget;
+    const shared_ptr<const OpeningBook> book;
+};
+
+#endif // !BOT_H
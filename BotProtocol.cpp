@@ -0,0 +1,306 @@
+#include "BotProtocol.h"
+#include "Notation.h"
+
+#include <algorithm>
+#include <cctype>
+
+using std::make_unique;
+using std::ostringstream;
+
+BotProtocol::BotProtocol() : over(false), finished(false) {}
+
+string BotProtocol::handle(const string& request) {
+    istringstream words(request);
+    string operation;
+    words >> operation;
+    transform(operation.begin(), operation.end(), operation.begin(),
+        ::tolower);
+
+    string response;
+    bool playing = game != nullptr && game->board != nullptr;
+    if (operation == "new") {
+        response = newGame(words);
+    } else if (operation == "quit") {
+        finished = true;
+        response = "ok";
+    } else if (!playing) {
+        response = "err no game";
+    } else if (operation == "state") {
+        response = state();
+    } else if (operation == "board") {
+        response = board();
+    } else if (operation == "moves") {
+        response = moves();
+    } else if (operation == "place") {
+        response = place(words);
+    } else if (operation == "replace") {
+        response = replace(words);
+    } else if (operation == "undo") {
+        response = undo();
+    } else if (operation == "complete") {
+        response = complete(words);
+    } else {
+        response = "err unknown request";
+    }
+
+    return response;
+}
+
+bool BotProtocol::isFinished() const { return finished; }
+
+string BotProtocol::newGame(istringstream& request) {
+    string player1Name, player2Name, seed;
+    request >> player1Name >> player2Name >> seed;
+    if (player1Name.empty() || player2Name.empty() ||
+        player1Name == player2Name)
+        return "err two different names needed";
+    else if (!seed.empty() && (seed.size() > SEED_DIGITS ||
+        !std::all_of(seed.begin(), seed.end(), ::isdigit)))
+        return "err bad seed";
+
+    if (!game) {
+        game = make_unique<GameManager>();
+        game->listener = [this](const string& message, State state) {
+            outcomes.push_back(state);
+            if (state == PLACE_FAILURE || state == REPLACE_FAILURE)
+                failure = message;
+            else if (state == GAME_OVER)
+                over = true;
+        };
+    }
+
+    if (seed.empty())
+        game->beginGame(player1Name, player2Name);
+    else
+        game->beginGame(player1Name, player2Name, std::stoull(seed));
+    history.clear();
+    over = false;
+
+    return "ok";
+}
+
+string BotProtocol::state() const {
+    ostringstream response;
+    response << "ok " << (game->currentPlayer == game->player1 ? 1 : 2)
+             << " " << game->player1->getScore()
+             << " " << game->player2->getScore()
+             << " " << game->bag->getTiles()->size() << " ";
+
+    shared_ptr<const TileList> hand =
+        game->currentPlayer->getHand()->getTiles();
+    if (hand->isEmpty())
+        response << "-";
+    else
+        response << *hand;
+
+    if (over)
+        response << " over";
+
+    return response.str();
+}
+
+string BotProtocol::board() const {
+    const LineIndex<StandardRules>& index = game->board->getIndex();
+    BoardBounds bounds = game->board->getBounds();
+    ostringstream tiles;
+    for (size_t row = bounds.top; row < bounds.bottom; ++row) {
+        for (size_t column = bounds.left; column < bounds.right; ++column) {
+            uint8_t kind = index.kindAt(row, column);
+            if (kind != LineIndex<StandardRules>::NO_TILE)
+                tiles << " " << kindCode(kind) << "@"
+                      << formatPosition(row, column);
+        }
+    }
+
+    return "ok " + std::to_string(index.getTileCount()) + tiles.str();
+}
+
+string BotProtocol::moves() const {
+    typedef LineIndex<StandardRules>::KindMask KindMask;
+    const LineIndex<StandardRules>& index = game->board->getIndex();
+    KindMask hand = over ? 0 : game->currentPlayer->getHand()->getKindMask();
+    size_t count = 0;
+    ostringstream list;
+
+    if (index.getTileCount() == 0) {
+        // the first tile scores a point wherever it goes
+        for (size_t kind = 0; kind < StandardRules::KINDS; ++kind) {
+            if (hand & (KindMask(1) << kind)) {
+                list << " " << kindCode(kind) << "@*:1";
+                ++count;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < index.getFrontierSize(); ++i) {
+        size_t row = index.getFrontierCell(i) / StandardRules::BOARD_LENGTH;
+        size_t column =
+            index.getFrontierCell(i) % StandardRules::BOARD_LENGTH;
+        LineIndex<StandardRules>::Fit fit = index.fit(row, column, hand);
+        KindMask accepted = fit.kinds;
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if (accepted & 1) {
+                list << " " << kindCode(kind) << "@"
+                     << formatPosition(row, column) << ":"
+                     << size_t(fit.points);
+                ++count;
+            }
+        }
+    }
+
+    return "ok " + std::to_string(count) + list.str();
+}
+
+string BotProtocol::place(istringstream& request) {
+    string tile, position;
+    request >> tile >> position;
+    transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
+    transform(position.begin(), position.end(), position.begin(), ::toupper);
+
+    Colour colour;
+    Shape shape;
+    size_t row;
+    size_t column;
+    if (over)
+        return "err game over";
+    else if (!parseTile(tile, colour, shape))
+        return "err bad tile";
+
+    // the first tile listed at any location goes in the middle, as the bots
+    // play it, and the response gives the location it went to
+    if (position == "*" && game->board->isEmpty()) {
+        row = StandardRules::BOARD_LENGTH / 2;
+        column = StandardRules::BOARD_LENGTH / 2;
+        position = formatPosition(row, column);
+    } else if (!parsePosition(position, row, column)) {
+        return "err bad location";
+    }
+
+    bool first = game->currentPlayer == game->player1;
+    size_t score = game->currentPlayer->getScore();
+    KindCounts before = handKinds(*game->currentPlayer);
+
+    checkpoint();
+    game->placeTile(colour, shape, row, column);
+
+    bool succeeded;
+    string response = outcomeCodes(succeeded);
+    if (!succeeded) {
+        history.pop_back();
+        return response + " " + failure;
+    }
+
+    const Player& mover = first ? *game->player1 : *game->player2;
+    size_t kind = StandardRules::kindOf(Tile(colour, shape));
+    size_t drawn = drawnKind(before, handKinds(mover), kind);
+
+    return response + " " + tile + "@" + position + " " +
+        std::to_string(mover.getScore() - score) + " " +
+        (drawn < StandardRules::KINDS ? kindCode(drawn) : "-");
+}
+
+string BotProtocol::replace(istringstream& request) {
+    string tile;
+    request >> tile;
+    transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
+
+    Colour colour;
+    Shape shape;
+    if (over)
+        return "err game over";
+    else if (!parseTile(tile, colour, shape))
+        return "err bad tile";
+
+    bool first = game->currentPlayer == game->player1;
+    KindCounts before = handKinds(*game->currentPlayer);
+
+    checkpoint();
+    game->replaceTile(colour, shape);
+
+    bool succeeded;
+    string response = outcomeCodes(succeeded);
+    if (!succeeded) {
+        history.pop_back();
+        return response + " " + failure;
+    }
+
+    const Player& mover = first ? *game->player1 : *game->player2;
+    size_t kind = StandardRules::kindOf(Tile(colour, shape));
+
+    return response + " " + tile + " " +
+        kindCode(drawnKind(before, handKinds(mover), kind));
+}
+
+string BotProtocol::undo() {
+    if (history.empty())
+        return "err nothing to undo";
+
+    game->restore(*history.back());
+    history.pop_back();
+    over = false;
+
+    return "ok";
+}
+
+string BotProtocol::complete(istringstream& request) const {
+    TileList line;
+    string tile;
+    while (request >> tile) {
+        transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
+        Colour colour;
+        Shape shape;
+        if (!parseTile(tile, colour, shape))
+            return "err bad tile";
+        line.addBack(make_shared<Tile>(colour, shape));
+    }
+
+    bool completable =
+        game->currentPlayer->getUnseen().canCompleteQwirkle(line);
+
+    return completable ? "ok 1" : "ok 0";
+}
+
+void BotProtocol::checkpoint() {
+    history.push_back(game->snapshot());
+    outcomes.clear();
+}
+
+string BotProtocol::outcomeCodes(bool& succeeded) const {
+    string codes;
+    succeeded = true;
+    for (State state : outcomes) {
+        codes += (codes.empty() ? "" : ",") + std::to_string(state);
+        succeeded = succeeded &&
+            state != PLACE_FAILURE && state != REPLACE_FAILURE;
+    }
+
+    return codes;
+}
+
+BotProtocol::KindCounts BotProtocol::handKinds(const Player& player) {
+    KindCounts counts{};
+    shared_ptr<const TileList> hand = player.getHand()->getTiles();
+    for (const shared_ptr<Tile>& tile : *hand)
+        ++counts[StandardRules::kindOf(*tile)];
+
+    return counts;
+}
+
+size_t BotProtocol::drawnKind(const KindCounts& before,
+    const KindCounts& after, size_t played) {
+    size_t drawn = StandardRules::KINDS;
+    for (size_t kind = 0; kind < StandardRules::KINDS; ++kind) {
+        if (after[kind] + (kind == played ? 1 : 0) > before[kind])
+            drawn = kind;
+    }
+
+    return drawn;
+}
+
+string BotProtocol::kindCode(size_t kind) {
+    ostringstream code;
+    code << Tile(StandardRules::colourAt(kind / StandardRules::TYPES),
+        StandardRules::shapeAt(kind % StandardRules::TYPES));
+
+    return code.str();
+}
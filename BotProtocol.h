@@ -0,0 +1,122 @@
+#ifndef BOT_PROTOCOL_H
+#define BOT_PROTOCOL_H
+
+#include "GameManager.h"
+
+#include <array>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::array;
+using std::istringstream;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+/**
+ * @note
+ * A line protocol for programs playing the game, with no prompts and no
+ * rendering. Each request is a line and is answered by a single line that
+ * starts with a code, "ok" or "err <reason>" for requests that do not move,
+ * and for moves the State of each outcome in the order GameManager reported
+ * it, such as "5,0" for a QWIRKLE scored by a placement. A move is answered
+ * with what it changed rather than with the board.
+ *
+ *   new <name1> <name2>  ok
+ *   state                ok <turn 1|2> <score1> <score2> <bag> <hand> [over]
+ *   board                ok <count> <tile>@<location>...
+ *   moves                ok <count> <tile>@<location>:<points>...
+ *   place <tile> <loc>   0 <tile>@<location> <points> <drawn|->
+ *   replace <tile>       2 <tile> <drawn>
+ *   undo                 ok
+ *   complete [<tile>...] ok <0|1>
+ *   quit                 ok
+ *
+ * A failed move is answered by its code and GameManager's message. The
+ * location of a move on an empty board is listed as *, where any location
+ * will do, and placing a tile at * puts it in the middle of the board. The
+ * points listed for a move leave out the bonus for emptying the hand. A seed
+ * after the names of a new game deals it the same way every time. Complete
+ * answers whether a line of the given tiles could still become a QWIRKLE,
+ * from what the player to move has not seen.
+ */
+class BotProtocol {
+public:
+    /**
+     * Construct a protocol with no game in progress.
+     */
+    BotProtocol();
+
+    /**
+     * Answer a request.
+     *
+     * @param request - the request, without its line break
+     * @return the response, without a line break
+     */
+    string handle(const string& request);
+
+    /**
+     * Query whether the client has quit.
+     */
+    bool isFinished() const;
+
+private:
+    typedef array<uint8_t, StandardRules::KINDS> KindCounts;
+
+    // the most digits a seed can have and still fit in 64 bits
+    static constexpr size_t SEED_DIGITS = 19;
+
+    string newGame(istringstream& request);
+    string state() const;
+    string board() const;
+    string moves() const;
+    string place(istringstream& request);
+    string replace(istringstream& request);
+    string undo();
+    string complete(istringstream& request) const;
+
+    /**
+     * Take a snapshot to undo the next move to, discarded again if the move
+     * fails. The move then copies the game out of the snapshot onto the
+     * heap, so each move held in the history costs one copy of the game,
+     * freed when the move is undone or a new game begins.
+     */
+    void checkpoint();
+
+    /**
+     * Get the codes of the outcomes reported since the last move, joined by
+     * commas, and whether the move succeeded.
+     */
+    string outcomeCodes(bool& succeeded) const;
+
+    /**
+     * Get the number of tiles of each kind in a player's hand.
+     */
+    static KindCounts handKinds(const Player& player);
+
+    /**
+     * Get the kind a hand gained, the tile drawn by a move.
+     *
+     * @param before,after - the hand before and after the move
+     * @param played - the kind the move took from the hand
+     * @return the kind drawn, KINDS if none was
+     */
+    static size_t drawnKind(const KindCounts& before, const KindCounts& after,
+        size_t played);
+
+    /**
+     * Get the code of a kind, such as R1.
+     */
+    static string kindCode(size_t kind);
+
+    unique_ptr<GameManager> game;
+    vector<shared_ptr<const GameSnapshot>> history;
+    vector<State> outcomes;
+    string failure;
+    bool over;
+    bool finished;
+};
+
+#endif // !BOT_PROTOCOL_H
@@ -6,10 +6,6 @@
  * @note
  * A file to organise all constants used throughout the game.
  */
-#define HAND_SIZE               6
-#define MAX_LINE_SIZE           6
-#define SCORE_BONUS             6
-#define BOARD_LENGTH            26
 #define ASCII_ALPHABET_BEGIN    65
 #define ASCII_NUMERICAL_BEGIN   48
 #define ASCII_ALPHABET_END      90
@@ -18,9 +14,14 @@
 #define THIRD_POSITION          2
 #define STRING_SIZE_2           2
 #define STRING_SIZE_3           3
-#define MAX_BOARD_INDEX         BOARD_LENGTH - 1
+#define STRING_SIZE_5           5
 #define MIN_TILE_RANGE          0
 #define MAX_TILE_RANGE          9
+#define HINT_BUDGET_MS          100
+#define HINT_CANDIDATES         3
+#define SOLVE_BUDGET_MS         1000
+#define ANSI_CLEAR_SCREEN       "\033[2J\033[H"
+#define ANSI_RELEASE_SCREEN     "\0337\033[r\0338"
 #define ERROR_MESSAGE           "Invalid input - "
 #define SPLASH_SCREEN           "\n░█▀▀█ ░█──░█ ▀█▀ ░█▀▀█ ░█─▄▀ ░█─── ░█▀▀▀\n░█─░█ ░█░█░█ ░█─ ░█▄▄▀ ░█▀▄─ ░█─── ░█▀▀▀\n─▀▀█▄ ░█▄▀▄█ ▄█▄ ░█─░█ ░█─░█ ░█▄▄█ ░█▄▄▄\n"
 
@@ -0,0 +1,424 @@
+#include "EndgameSolver.h"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+
+using std::invalid_argument;
+
+// the seed of the Zobrist keys, any fixed value will do
+static const uint64_t KEY_SEED = 0x51a7e5eedULL;
+
+// beyond any margin a game can end with
+static const int UNBOUNDED = 1 << 14;
+
+template <class Rules>
+EndgameSolver<Rules>::EndgameSolver(
+    const BasicGameSnapshot<Rules>& snapshot, size_t tableSize)
+    : index(snapshot.getBoard()->getIndex()), key(0), table(tableSize),
+      ply(0), nodes(0), stopped(false) {
+    if (!snapshot.getBag()->getTiles()->isEmpty())
+        throw invalid_argument("the bag is not empty");
+
+    shared_ptr<const BasicPlayer<Rules>> player = snapshot.getCurrentPlayer();
+    mover = player == snapshot.getPlayer1() ? 0 : 1;
+
+    // with the bag empty, every tile the player has not seen is the
+    // opponent's
+    hands[0].fill(0);
+    hands[1].fill(0);
+    for (const shared_ptr<Tile>& tile : *player->getHand()->getTiles()) {
+        size_t kind = Rules::kindOf(*tile);
+        if (kind < Rules::KINDS)
+            ++hands[mover][kind];
+    }
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind)
+        hands[1 - mover][kind] = player->getUnseen().count(kind);
+
+    for (size_t seat = 0; seat < 2; ++seat) {
+        masks[seat] = 0;
+        handSizes[seat] = 0;
+        for (size_t kind = 0; kind < Rules::KINDS; ++kind) {
+            if (hands[seat][kind] != 0)
+                masks[seat] |= KindMask(1) << kind;
+            handSizes[seat] += hands[seat][kind];
+            key ^= handKeys()[
+                (seat * Rules::KINDS + kind) * (Rules::COPIES + 1) +
+                hands[seat][kind]];
+        }
+    }
+
+    for (size_t cell = 0; cell < Rules::CELLS; ++cell) {
+        size_t kind = index.kindAt(
+            cell / Rules::BOARD_LENGTH, cell % Rules::BOARD_LENGTH);
+        if (kind != LineIndex<Rules>::NO_TILE)
+            key ^= cellKeys()[cell * Rules::KINDS + kind];
+    }
+    if (mover == 1)
+        key ^= handKeys().back();
+
+    // a pass never follows a pass, so a line has at most two moves a tile
+    options.resize(2 * (handSizes[0] + handSizes[1]) + 2);
+    lines.resize(options.size() + 1);
+    candidates.resize(options.size() + 1);
+    for (size_t i = 0; i < index.getFrontierSize(); ++i)
+        consider(index.getFrontierCell(i), candidates[0]);
+    history[0].assign(Rules::CELLS * Rules::KINDS, 0);
+    history[1].assign(Rules::CELLS * Rules::KINDS, 0);
+}
+
+template <class Rules>
+EndgameResult EndgameSolver<Rules>::solve(Clock::duration budget) {
+    Clock::time_point start = Clock::now();
+    EndgameResult result = {vector<EndgameMove>(), 0, false, 0, 0, 0};
+    deadline = Clock::time_point::max();
+    nodes = 0;
+    stopped = false;
+
+    // every tile left is a ply at most, passes do not count
+    size_t plies = handSizes[0] + handSizes[1];
+    if (handSizes[0] == 0 || handSizes[1] == 0)
+        result.solved = true;
+
+    for (size_t depth = 1; depth <= plies && !result.solved; depth += 2) {
+        bool complete = true;
+        ply = 0;
+        int margin = search(depth, -UNBOUNDED, UNBOUNDED, false, complete);
+        if (stopped)
+            break;
+
+        result.margin = margin;
+        result.solved = complete;
+        result.depth = depth;
+        result.line.clear();
+        for (const Option& option : lines[0]) {
+            result.line.push_back({option.kind,
+                uint8_t(option.cell / Rules::BOARD_LENGTH),
+                uint8_t(option.cell % Rules::BOARD_LENGTH), option.points});
+        }
+
+        // the first iteration is always completed
+        deadline = start + budget;
+    }
+
+    result.nodes = nodes;
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+        Clock::now() - start).count();
+
+    return result;
+}
+
+template <class Rules>
+int EndgameSolver<Rules>::search(
+    size_t depth, int alpha, int beta, bool passed, bool& complete) {
+    lines[ply].clear();
+
+    // the game is over once a hand is empty
+    if (visit() || handSizes[0] == 0 || handSizes[1] == 0)
+        return 0;
+    if (depth == 0) {
+        complete = false;
+        return 0;
+    }
+
+    // the table only cuts off null window searches, so that the best line
+    // is always searched in full and can be read back
+    bool principal = beta - alpha > 1;
+    Entry* entry = &entryFor(key);
+    uint8_t firstKind = LineIndex<Rules>::NO_TILE;
+    uint16_t firstCell = 0;
+    if (entry->key == key) {
+        firstKind = entry->kind;
+        firstCell = entry->cell;
+        bool deepEnough = entry->complete || entry->depth >= depth;
+        bool bounds = entry->bound == EXACT ||
+            (entry->bound == LOWER && entry->value >= beta) ||
+            (entry->bound == UPPER && entry->value <= alpha);
+        if (!principal && deepEnough && bounds) {
+            complete = complete && entry->complete;
+            return entry->value;
+        }
+    }
+
+    // the last tile ends the game, so the best place for it is the one
+    // scoring most
+    if (handSizes[mover] == 1) {
+        Option last;
+        if (finish(last)) {
+            lines[ply].assign(1, last);
+            return last.points;
+        }
+    }
+
+    vector<Option>& moves = options[ply];
+    generate(moves, firstKind, firstCell);
+    if (moves.empty()) {
+        // neither player can place, or the other player moves again
+        int value = 0;
+        if (!passed) {
+            pass();
+            candidates[ply + 1] = candidates[ply];
+            ++ply;
+            value = -search(depth, -beta, -alpha, true, complete);
+            --ply;
+            pass();
+
+            lines[ply].assign(1, {0, LineIndex<Rules>::NO_TILE, 0});
+            lines[ply].insert(lines[ply].end(), lines[ply + 1].begin(),
+                lines[ply + 1].end());
+        }
+
+        return value;
+    }
+
+    int best = -UNBOUNDED;
+    int floor = alpha;
+    bool searched = true;
+    Option bestMove = moves.front();
+    for (size_t i = 0; i < moves.size(); ++i) {
+        const Option& option = moves[i];
+        play(option);
+        ++ply;
+
+        // after the first move, a null window shows whether a move is any
+        // better, and only one that is gets searched again in full
+        int value;
+        if (i == 0) {
+            value = option.points - search(depth - 1,
+                option.points - beta, option.points - alpha, false, searched);
+        } else {
+            value = option.points - search(depth - 1,
+                option.points - alpha - 1, option.points - alpha, false,
+                searched);
+            if (value > alpha && value < beta && !stopped) {
+                value = option.points - search(depth - 1,
+                    option.points - beta, option.points - alpha, false,
+                    searched);
+            }
+        }
+
+        --ply;
+        undo(option);
+        if (stopped)
+            return 0;
+
+        if (value > best) {
+            best = value;
+            bestMove = option;
+            if (principal && value > alpha) {
+                lines[ply].assign(1, option);
+                lines[ply].insert(lines[ply].end(), lines[ply + 1].begin(),
+                    lines[ply + 1].end());
+            }
+        }
+        alpha = std::max(alpha, value);
+        if (alpha >= beta) {
+            history[mover][option.cell * Rules::KINDS + option.kind] +=
+                depth * depth;
+            break;
+        }
+    }
+
+    // a deeper entry for another position is kept, unless this one was
+    // searched to the end of the game and so holds at any depth
+    entry = &entryFor(key);
+    if (entry->key == key || entry->depth <= depth || searched) {
+        entry->key = key;
+        entry->value = best;
+        entry->cell = bestMove.cell;
+        entry->kind = bestMove.kind;
+        entry->depth = depth;
+        entry->bound = best <= floor ? UPPER : best >= beta ? LOWER : EXACT;
+        entry->complete = searched;
+    }
+    complete = complete && searched;
+
+    return best;
+}
+
+template <class Rules>
+void EndgameSolver<Rules>::generate(
+    vector<Option>& options, uint8_t firstKind, uint16_t firstCell) const {
+    options.clear();
+    KindMask kinds = masks[mover];
+
+    // emptying the first player's hand earns the bonus GameManager gives
+    size_t bonus = mover == 0 && handSizes[0] == 1 ? Rules::SCORE_BONUS : 0;
+    for (const Candidate& candidate : candidates[ply]) {
+        KindMask accepted = candidate.accepted & kinds;
+        if (accepted == 0)
+            continue;
+
+        uint8_t points = uint8_t(index.fit(
+            candidate.cell / Rules::BOARD_LENGTH,
+            candidate.cell % Rules::BOARD_LENGTH, accepted).points + bonus);
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if ((accepted & 1) != 0)
+                options.push_back({candidate.cell, uint8_t(kind), points});
+        }
+    }
+
+    // the table's move first, then the highest scoring, then those that
+    // cut off most often elsewhere
+    const vector<uint32_t>& cutoffs = history[mover];
+    std::sort(options.begin(), options.end(),
+        [firstKind, firstCell, &cutoffs](const Option& a, const Option& b) {
+            bool aFirst = a.kind == firstKind && a.cell == firstCell;
+            bool bFirst = b.kind == firstKind && b.cell == firstCell;
+            if (aFirst != bFirst)
+                return aFirst;
+            if (a.points != b.points)
+                return a.points > b.points;
+            return cutoffs[a.cell * Rules::KINDS + a.kind] >
+                cutoffs[b.cell * Rules::KINDS + b.kind];
+        });
+}
+
+template <class Rules>
+bool EndgameSolver<Rules>::finish(Option& best) const {
+    size_t kind = 0;
+    while ((masks[mover] >> kind & 1) == 0)
+        ++kind;
+
+    bool found = false;
+    size_t bonus = mover == 0 ? Rules::SCORE_BONUS : 0;
+    for (const Candidate& candidate : candidates[ply]) {
+        if ((candidate.accepted >> kind & 1) == 0)
+            continue;
+
+        uint8_t points = uint8_t(index.fit(
+            candidate.cell / Rules::BOARD_LENGTH,
+            candidate.cell % Rules::BOARD_LENGTH,
+            KindMask(1) << kind).points + bonus);
+        if (!found || points > best.points)
+            best = {candidate.cell, uint8_t(kind), points};
+        found = true;
+    }
+
+    return found;
+}
+
+template <class Rules>
+void EndgameSolver<Rules>::play(const Option& option) {
+    const vector<uint64_t>& counts = handKeys();
+    size_t slot = (mover * Rules::KINDS + option.kind) * (Rules::COPIES + 1);
+    uint8_t& held = hands[mover][option.kind];
+
+    index.push(option.kind, option.cell / Rules::BOARD_LENGTH,
+        option.cell % Rules::BOARD_LENGTH);
+    key ^= cellKeys()[option.cell * Rules::KINDS + option.kind];
+    key ^= counts[slot + held] ^ counts[slot + held - 1];
+    if (--held == 0)
+        masks[mover] &= ~(KindMask(1) << option.kind);
+    --handSizes[mover];
+    pass();
+
+    // only the cells at the ends of the lines through the tile accept
+    // anything new, every other cell keeps what it accepted
+    size_t row = option.cell / Rules::BOARD_LENGTH;
+    size_t column = option.cell % Rules::BOARD_LENGTH;
+    array<size_t, 4> ends = {
+        lineEnd(row, column, 0, -1), lineEnd(row, column, 0, 1),
+        lineEnd(row, column, -1, 0), lineEnd(row, column, 1, 0)};
+
+    vector<Candidate>& next = candidates[ply + 1];
+    next.clear();
+    for (const Candidate& candidate : candidates[ply]) {
+        if (candidate.cell != option.cell &&
+            std::find(ends.begin(), ends.end(), candidate.cell) == ends.end())
+            next.push_back(candidate);
+    }
+    for (size_t end : ends) {
+        if (end < Rules::CELLS)
+            consider(end, next);
+    }
+}
+
+template <class Rules>
+size_t EndgameSolver<Rules>::lineEnd(
+    size_t row, size_t column, int rowStep, int columnStep) const {
+    do {
+        row += rowStep;
+        column += columnStep;
+        if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH)
+            return Rules::CELLS;
+    } while (index.kindAt(row, column) != LineIndex<Rules>::NO_TILE);
+
+    return row * Rules::BOARD_LENGTH + column;
+}
+
+template <class Rules>
+void EndgameSolver<Rules>::consider(
+    size_t cell, vector<Candidate>& cells) const {
+    KindMask accepted = masks[0] | masks[1];
+    accepted &= index.acceptedKinds(
+        cell / Rules::BOARD_LENGTH, cell % Rules::BOARD_LENGTH);
+    if (accepted != 0)
+        cells.push_back({uint16_t(cell), accepted});
+}
+
+template <class Rules>
+void EndgameSolver<Rules>::undo(const Option& option) {
+    pass();
+    const vector<uint64_t>& counts = handKeys();
+    size_t slot = (mover * Rules::KINDS + option.kind) * (Rules::COPIES + 1);
+    uint8_t& held = hands[mover][option.kind];
+
+    ++handSizes[mover];
+    masks[mover] |= KindMask(1) << option.kind;
+    ++held;
+    key ^= counts[slot + held] ^ counts[slot + held - 1];
+    key ^= cellKeys()[option.cell * Rules::KINDS + option.kind];
+    index.pop();
+}
+
+template <class Rules>
+void EndgameSolver<Rules>::pass() {
+    mover = 1 - mover;
+    key ^= handKeys().back();
+}
+
+template <class Rules>
+typename EndgameSolver<Rules>::Entry& EndgameSolver<Rules>::entryFor(
+    uint64_t key) {
+    return table[key & (table.size() - 1)];
+}
+
+template <class Rules>
+bool EndgameSolver<Rules>::visit() {
+    // reading the clock every few nodes keeps its cost out of the search
+    if ((++nodes & 255) == 0 && Clock::now() >= deadline)
+        stopped = true;
+
+    return stopped;
+}
+
+template <class Rules>
+const vector<uint64_t>& EndgameSolver<Rules>::cellKeys() {
+    static const vector<uint64_t> keys = [] {
+        std::mt19937_64 random(KEY_SEED);
+        vector<uint64_t> keys(Rules::CELLS * Rules::KINDS);
+        for (uint64_t& key : keys)
+            key = random();
+        return keys;
+    }();
+
+    return keys;
+}
+
+template <class Rules>
+const vector<uint64_t>& EndgameSolver<Rules>::handKeys() {
+    // the last key is for the second player being the one to move
+    static const vector<uint64_t> keys = [] {
+        std::mt19937_64 random(~KEY_SEED);
+        vector<uint64_t> keys(2 * Rules::KINDS * (Rules::COPIES + 1) + 1);
+        for (uint64_t& key : keys)
+            key = random();
+        return keys;
+    }();
+
+    return keys;
+}
+
+template class EndgameSolver<StandardRules>;
+template class EndgameSolver<ExtendedRules>;
@@ -0,0 +1,255 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+#include "GameSnapshot.h"
+#include "LineIndex.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+using std::array;
+using std::vector;
+
+/**
+ * A move in a solved line, a placement or a pass.
+ */
+struct EndgameMove {
+    // the kind placed, LineIndex::NO_TILE for a pass
+    uint8_t kind;
+    uint8_t row;
+    uint8_t column;
+
+    // the points the move scores, with any bonus for emptying the hand
+    uint8_t points;
+};
+
+/**
+ * The outcome of solving an endgame.
+ */
+struct EndgameResult {
+    // the best line found from the current player's move, empty if the game
+    // is already over
+    vector<EndgameMove> line;
+
+    // the points the current player ends up ahead of the opponent by from
+    // here on, with both playing the line
+    int margin;
+
+    // whether every line was searched to the end of the game, so the margin
+    // is exact and the first move optimal
+    bool solved;
+
+    // the number of plies of the deepest complete iteration
+    size_t depth;
+
+    size_t nodes;
+    double milliseconds;
+};
+
+/**
+ * @note
+ * Solves the game once the bag is empty. The player's unseen tiles are then
+ * exactly the opponent's hand, so the rest of the game is a game of perfect
+ * information, searched by negamax over the points the player to move gains
+ * over the other. Each iteration of an iterative deepening search goes two
+ * plies deeper, so every horizon falls after the same player's move, with a
+ * principal variation search that tries the transposition table's best move,
+ * then the highest scoring ones, then those that cut off most often first,
+ * until an iteration reaches the end of every line. Moves are played on a
+ * line index and a pair of kind counts and undone again, positions are keyed
+ * by a Zobrist hash updated with each move, and the cells that can take a
+ * tile are carried from ply to ply, only those the move touches being looked
+ * at again. A player who cannot place passes, and the game ends when a hand
+ * is empty or neither player can place.
+ */
+template <class Rules>
+class EndgameSolver {
+public:
+    typedef typename LineTable<Rules>::KindMask KindMask;
+    typedef array<uint8_t, Rules::KINDS> KindCounts;
+    typedef std::chrono::steady_clock Clock;
+
+    // the default number of transposition table entries, a power of two
+    static constexpr size_t DEFAULT_TABLE_SIZE = 1 << 20;
+
+    /**
+     * Construct a solver from the current player's point of view.
+     *
+     * @param snapshot - the game, its bag empty
+     * @param tableSize - the number of transposition table entries, a power
+     * of two
+     * @throws invalid_argument if tiles remain in the bag
+     */
+    explicit EndgameSolver(const BasicGameSnapshot<Rules>& snapshot,
+        size_t tableSize = DEFAULT_TABLE_SIZE);
+
+    /**
+     * Search until the game is solved or the budget runs out, answering from
+     * the deepest finished iteration. The first iteration is always
+     * finished.
+     *
+     * @param budget - the time allowed
+     * @return the best line found
+     */
+    EndgameResult solve(Clock::duration budget);
+
+private:
+    /**
+     * What the table knows of the value of a position.
+     */
+    enum Bound : uint8_t {
+        EXACT,
+        LOWER,
+        UPPER
+    };
+
+    /**
+     * A position searched before, its best move and the bound on its value
+     * found with the given number of plies left.
+     */
+    struct Entry {
+        uint64_t key;
+        int16_t value;
+        uint16_t cell;
+        uint8_t kind;
+        uint8_t depth;
+        Bound bound;
+
+        // whether the value was found without stopping at the horizon
+        bool complete;
+    };
+
+    /**
+     * A move considered at a node, with the points it scores now.
+     */
+    struct Option {
+        uint16_t cell;
+        uint8_t kind;
+        uint8_t points;
+    };
+
+    /**
+     * An empty cell that accepts some kind left in either hand.
+     */
+    struct Candidate {
+        uint16_t cell;
+        KindMask accepted;
+    };
+
+    /**
+     * Search a position to the given number of plies.
+     *
+     * @param depth - the plies left before the horizon
+     * @param alpha,beta - the window of values of interest
+     * @param passed - whether the last move was a pass
+     * @param complete - cleared if the value depends on the horizon
+     * @return the value for the player to move
+     */
+    int search(size_t depth, int alpha, int beta, bool passed,
+        bool& complete);
+
+    /**
+     * Get the placements the player to move can make, best first.
+     *
+     * @param options - set to the placements
+     * @param firstKind,firstCell - a placement to try before the others
+     */
+    void generate(vector<Option>& options, uint8_t firstKind,
+        uint16_t firstCell) const;
+
+    /**
+     * Find the highest scoring placement of the last tile in the hand of
+     * the player to move.
+     *
+     * @param best - set to the placement
+     * @return false if the tile cannot be placed
+     */
+    bool finish(Option& best) const;
+
+    /**
+     * Play a placement for the player to move and hand the turn over,
+     * finding the cells the next ply can place in.
+     */
+    void play(const Option& option);
+
+    /**
+     * Find the first empty cell from a tile in a direction.
+     *
+     * @param row,column - the tile
+     * @param rowStep,columnStep - the direction
+     * @return the cell, Rules::CELLS if it is off the board
+     */
+    size_t lineEnd(size_t row, size_t column, int rowStep,
+        int columnStep) const;
+
+    /**
+     * Add an empty cell to a list of candidates if it accepts some kind
+     * left in either hand.
+     */
+    void consider(size_t cell, vector<Candidate>& cells) const;
+
+    /**
+     * Undo play.
+     */
+    void undo(const Option& option);
+
+    /**
+     * Pass the turn over, or take it back.
+     */
+    void pass();
+
+    /**
+     * Get the table entry a position is stored in.
+     */
+    Entry& entryFor(uint64_t key);
+
+    /**
+     * Count a node, stopping the search once its deadline has passed.
+     *
+     * @return true if the search has stopped
+     */
+    bool visit();
+
+    /**
+     * Get the random keys of each kind in each cell, and of each count of
+     * each kind in each seat's hand.
+     */
+    static const vector<uint64_t>& cellKeys();
+    static const vector<uint64_t>& handKeys();
+
+    LineIndex<Rules> index;
+
+    // the kinds in each seat's hand, the first seat being player 1
+    array<KindCounts, 2> hands;
+    array<KindMask, 2> masks;
+    array<size_t, 2> handSizes;
+
+    // the seat to move
+    size_t mover;
+
+    uint64_t key;
+    vector<Entry> table;
+
+    // the placements at each ply of the line being searched, the best line
+    // found from each ply, a pass being a move of no kind, and the cells
+    // that can be placed in at each ply
+    vector<vector<Option>> options;
+    vector<vector<Option>> lines;
+    vector<vector<Candidate>> candidates;
+    size_t ply;
+
+    // how often each placement of each seat has cut the search off,
+    // weighted by depth
+    array<vector<uint32_t>, 2> history;
+
+    Clock::time_point deadline;
+    size_t nodes;
+    bool stopped;
+};
+
+template <class Rules>
+constexpr size_t EndgameSolver<Rules>::DEFAULT_TABLE_SIZE;
+
+#endif // !ENDGAME_SOLVER_H
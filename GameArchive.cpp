@@ -0,0 +1,339 @@
+#include "GameArchive.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::endl;
+using std::invalid_argument;
+using std::lock_guard;
+using std::out_of_range;
+using std::runtime_error;
+
+constexpr uint32_t ArchiveFormat::VERSION;
+constexpr size_t ArchiveFormat::KIND_BITS;
+constexpr size_t ArchiveFormat::DEAL_BYTES;
+constexpr uint16_t ArchiveFormat::CELL_BITS;
+constexpr uint16_t ArchiveFormat::REPLACE_CELL;
+constexpr uint16_t ArchiveFormat::PASS_CODE;
+constexpr size_t ArchiveWriter::BUFFER_BYTES;
+
+static const char FILE_MAGIC[8] = {'Q', 'W', 'K', 'A', 'R', 'C', 'H', '\0'};
+static const char FOOTER_MAGIC[8] = {'Q', 'W', 'K', 'I', 'N', 'D', 'E', 'X'};
+
+/**
+ * Write a whole buffer to a file.
+ *
+ * @return true if every byte was written
+ */
+static bool writeAll(int file, const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t count = write(file, data + offset, size - offset);
+        if (count <= 0 && errno != EINTR)
+            return false;
+        offset += count > 0 ? count : 0;
+    }
+
+    return true;
+}
+
+/**
+ * Append a 16 bit value to a buffer.
+ */
+static void put16(vector<uint8_t>& bytes, uint16_t value) {
+    bytes.push_back(value & 0xff);
+    bytes.push_back(value >> 8);
+}
+
+/**
+ * Read a 16 bit value from anywhere in memory.
+ */
+static uint16_t get16(const uint8_t* bytes) {
+    return uint16_t(bytes[0] | bytes[1] << 8);
+}
+
+uint16_t ArchiveFormat::encode(const ArchivedMove& move) {
+    uint16_t code = PASS_CODE;
+    if (move.action == ArchivedMove::PLACE) {
+        code = uint16_t(move.kind << CELL_BITS |
+            (move.row * StandardRules::BOARD_LENGTH + move.column));
+    } else if (move.action == ArchivedMove::REPLACE) {
+        code = uint16_t(move.kind << CELL_BITS | REPLACE_CELL);
+    }
+
+    return code;
+}
+
+ArchivedMove ArchiveFormat::decode(uint16_t code) {
+    ArchivedMove move = {ArchivedMove::PASS, 0, 0, 0};
+    size_t cell = code & REPLACE_CELL;
+    if (code != PASS_CODE) {
+        move.action = cell == REPLACE_CELL
+            ? ArchivedMove::REPLACE : ArchivedMove::PLACE;
+        move.kind = uint8_t(code >> CELL_BITS);
+    }
+    if (move.action == ArchivedMove::PLACE) {
+        move.row = uint8_t(cell / StandardRules::BOARD_LENGTH);
+        move.column = uint8_t(cell % StandardRules::BOARD_LENGTH);
+    }
+
+    return move;
+}
+
+ArchiveWriter::ArchiveWriter(const string& fileName)
+    : fileName(fileName), written(0) {
+    file = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        0644);
+    if (file < 0)
+        throw runtime_error(fileName + ": " + strerror(errno));
+
+    ArchiveFormat::FileHeader header{};
+    memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = ArchiveFormat::VERSION;
+    header.tiles = StandardRules::TILES;
+    header.cells = StandardRules::CELLS;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+    buffer.assign(bytes, bytes + sizeof(header));
+    buffer.reserve(BUFFER_BYTES);
+}
+
+ArchiveWriter::~ArchiveWriter() {
+    try {
+        close();
+    } catch (const runtime_error& e) {
+        cerr << "Archive to " << fileName << " failed." << endl;
+    }
+}
+
+void ArchiveWriter::add(const ArchivedGame& game) {
+    if (game.deal.size() != StandardRules::TILES)
+        throw invalid_argument("a game must be dealt every tile");
+
+    vector<uint8_t> bytes;
+    for (const string& name : game.names) {
+        if (name.size() > UINT8_MAX)
+            throw invalid_argument("name is too long: " + name);
+        bytes.push_back(uint8_t(name.size()));
+        bytes.insert(bytes.end(), name.begin(), name.end());
+    }
+    put16(bytes, game.scores[0]);
+    put16(bytes, game.scores[1]);
+    if (game.moves.size() > UINT16_MAX)
+        throw invalid_argument("a game has too many moves");
+    put16(bytes, uint16_t(game.moves.size()));
+
+    // the deal is packed a kind to every KIND_BITS bits
+    size_t dealt = bytes.size();
+    bytes.resize(dealt + ArchiveFormat::DEAL_BYTES, 0);
+    for (size_t i = 0; i < game.deal.size(); ++i) {
+        size_t bit = i * ArchiveFormat::KIND_BITS;
+        uint16_t shifted = uint16_t(game.deal[i] << bit % 8);
+        bytes[dealt + bit / 8] |= shifted & 0xff;
+        if (shifted >> 8)
+            bytes[dealt + bit / 8 + 1] |= shifted >> 8;
+    }
+
+    for (const ArchivedMove& move : game.moves)
+        put16(bytes, ArchiveFormat::encode(move));
+
+    lock_guard<mutex> guard(lock);
+    if (file < 0)
+        throw runtime_error(fileName + ": the archive is closed");
+    offsets.push_back(written + buffer.size());
+    buffer.insert(buffer.end(), bytes.begin(), bytes.end());
+    if (buffer.size() >= BUFFER_BYTES)
+        flush();
+}
+
+void ArchiveWriter::close() {
+    lock_guard<mutex> guard(lock);
+    if (file < 0)
+        return;
+
+    ArchiveFormat::Footer footer{};
+    footer.indexOffset = written + buffer.size();
+    footer.games = offsets.size();
+    memcpy(footer.magic, FOOTER_MAGIC, sizeof(footer.magic));
+
+    const uint8_t* index = reinterpret_cast<const uint8_t*>(offsets.data());
+    buffer.insert(buffer.end(), index, index + offsets.size() * 8);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&footer);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(footer));
+
+    bool flushed = writeAll(file, buffer.data(), buffer.size());
+    bool closed = ::close(file) == 0;
+    file = -1;
+    if (!flushed || !closed)
+        throw runtime_error(fileName + ": " + strerror(errno));
+}
+
+size_t ArchiveWriter::getGameCount() const {
+    lock_guard<mutex> guard(lock);
+    return offsets.size();
+}
+
+void ArchiveWriter::flush() {
+    if (!writeAll(file, buffer.data(), buffer.size()))
+        throw runtime_error(fileName + ": " + strerror(errno));
+
+    written += buffer.size();
+    buffer.clear();
+}
+
+ArchiveEntry::ArchiveEntry(const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    bool valid = true;
+    for (size_t seat = 0; seat < 2 && valid; ++seat) {
+        valid = offset < size && offset + 1 + data[offset] <= size;
+        if (valid) {
+            nameLengths[seat] = data[offset];
+            names[seat] = data + offset + 1;
+            offset += 1 + nameLengths[seat];
+        }
+    }
+
+    valid = valid && offset + 6 + ArchiveFormat::DEAL_BYTES <= size;
+    if (valid) {
+        scores = {get16(data + offset), get16(data + offset + 2)};
+        moveCount = get16(data + offset + 4);
+        dealt = data + offset + 6;
+        moves = dealt + ArchiveFormat::DEAL_BYTES;
+        valid = size_t(moves - data) + 2 * moveCount <= size;
+    }
+
+    if (!valid)
+        throw runtime_error("the archived game is not valid");
+}
+
+string ArchiveEntry::getName(size_t seat) const {
+    return string(reinterpret_cast<const char*>(names[seat]),
+        nameLengths[seat]);
+}
+
+size_t ArchiveEntry::getScore(size_t seat) const { return scores[seat]; }
+
+size_t ArchiveEntry::getMoveCount() const { return moveCount; }
+
+ArchivedMove ArchiveEntry::getMove(size_t index) const {
+    return ArchiveFormat::decode(get16(moves + 2 * index));
+}
+
+uint8_t ArchiveEntry::getDealt(size_t index) const {
+    // DEAL_BYTES rounds up, so the byte after a kind's first is in the deal
+    // whenever the kind spills into it
+    size_t bit = index * ArchiveFormat::KIND_BITS;
+    size_t bits = dealt[bit / 8];
+    if (bit % 8 + ArchiveFormat::KIND_BITS > 8)
+        bits |= size_t(dealt[bit / 8 + 1]) << 8;
+
+    return uint8_t(bits >> bit % 8 & ((1 << ArchiveFormat::KIND_BITS) - 1));
+}
+
+void ArchiveEntry::deal(GameManager& manager) const {
+    shared_ptr<Arena> arena = make_shared<Arena>(manager.chunkSize);
+    ArenaAllocator<Tile> tileAllocator(arena);
+    shared_ptr<TileBag> bag = allocate_shared<TileBag>(
+        ArenaAllocator<TileBag>(arena), arena);
+    for (size_t i = 0; i < StandardRules::TILES; ++i) {
+        size_t kind = getDealt(i);
+        bag->getTiles()->addBack(allocate_shared<Tile>(tileAllocator,
+            StandardRules::colourAt(kind / StandardRules::TYPES),
+            StandardRules::shapeAt(kind % StandardRules::TYPES)));
+    }
+
+    // the hands are drawn from the back as GameManager::beginGame draws them
+    ArenaAllocator<Player> playerAllocator(arena);
+    shared_ptr<Player> first = allocate_shared<Player>(
+        playerAllocator, getName(0), bag->getHand());
+    shared_ptr<Player> second = allocate_shared<Player>(
+        playerAllocator, getName(1), bag->getHand());
+    shared_ptr<GameBoard> board = allocate_shared<GameBoard>(
+        ArenaAllocator<GameBoard>(arena));
+
+    manager.loadGame(first, second, bag, board, first, arena);
+}
+
+void ArchiveEntry::play(GameManager& manager, const ArchivedMove& move) {
+    Colour colour = StandardRules::colourAt(move.kind / StandardRules::TYPES);
+    Shape shape = StandardRules::shapeAt(move.kind % StandardRules::TYPES);
+    if (move.action == ArchivedMove::PLACE)
+        manager.placeTile(colour, shape, move.row, move.column);
+    else if (move.action == ArchivedMove::REPLACE)
+        manager.replaceTile(colour, shape);
+    else
+        manager.switchPlayer();
+}
+
+ArchiveReader::ArchiveReader(const string& fileName)
+    : data(nullptr), size(0), indexOffset(0), games(0) {
+    int file = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) < 0) {
+        if (file >= 0)
+            ::close(file);
+        throw runtime_error(fileName + ": " + strerror(errno));
+    }
+
+    size = status.st_size;
+    void* mapped = size > 0
+        ? mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED;
+    ::close(file);
+    if (mapped == MAP_FAILED)
+        throw runtime_error(fileName + ": cannot be mapped");
+    data = static_cast<const uint8_t*>(mapped);
+
+    ArchiveFormat::FileHeader header;
+    ArchiveFormat::Footer footer;
+    bool valid = size >= sizeof(header) + sizeof(footer);
+    if (valid) {
+        memcpy(&header, data, sizeof(header));
+        memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+        indexOffset = footer.indexOffset;
+        games = footer.games;
+        valid = memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+            memcmp(footer.magic, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) == 0 &&
+            header.version == ArchiveFormat::VERSION &&
+            header.tiles == StandardRules::TILES &&
+            header.cells == StandardRules::CELLS &&
+            indexOffset >= sizeof(header) &&
+            indexOffset <= size - sizeof(footer) &&
+            (size - sizeof(footer) - indexOffset) / 8 == games &&
+            (size - sizeof(footer) - indexOffset) % 8 == 0;
+    }
+
+    if (!valid) {
+        munmap(const_cast<uint8_t*>(data), size);
+        throw runtime_error(fileName + ": not an archive");
+    }
+}
+
+ArchiveReader::~ArchiveReader() {
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+size_t ArchiveReader::getGameCount() const { return games; }
+
+ArchiveEntry ArchiveReader::getGame(size_t index) const {
+    if (index >= games)
+        throw out_of_range("no game " + std::to_string(index));
+
+    // a game ends where the next one starts, or at the index
+    uint64_t start;
+    uint64_t end = indexOffset;
+    memcpy(&start, data + indexOffset + 8 * index, 8);
+    if (index + 1 < games)
+        memcpy(&end, data + indexOffset + 8 * (index + 1), 8);
+    if (start < sizeof(ArchiveFormat::FileHeader) || start > end ||
+        end > indexOffset)
+        throw runtime_error("the archived game is not valid");
+
+    return ArchiveEntry(data + start, end - start);
+}
@@ -0,0 +1,268 @@
+#ifndef GAME_ARCHIVE_H
+#define GAME_ARCHIVE_H
+
+#include "GameManager.h"
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::array;
+using std::mutex;
+using std::string;
+using std::vector;
+
+/**
+ * A move of an archived game.
+ */
+struct ArchivedMove {
+    enum Action : uint8_t {
+        PLACE = 0,
+        REPLACE = 1,
+        PASS = 2
+    };
+
+    uint8_t action;
+
+    // the kind played or replaced, and the cell of a placement
+    uint8_t kind;
+    uint8_t row;
+    uint8_t column;
+};
+
+/**
+ * A complete game of the standard game, as it is added to an archive.
+ */
+struct ArchivedGame {
+    array<string, 2> names;
+    array<uint16_t, 2> scores;
+
+    // the kind of every tile in the bag as it was shuffled, front to back,
+    // before the hands were drawn from it
+    vector<uint8_t> deal;
+    vector<ArchivedMove> moves;
+};
+
+/**
+ * @note
+ * The layout of an archive of games, read by mapping it into memory as it
+ * is. All values are little-endian. A file is a 64 byte header, the games
+ * back to back, an index of the offset of each game and a 32 byte footer
+ * locating the index, so any game is found in constant time.
+ *
+ * A game is the length and bytes of each name, each final score and the
+ * number of moves as 16 bit values, the deal packed at KIND_BITS a tile and
+ * then the moves at two bytes each: the kind times 1024 plus the cell for a
+ * placement, plus REPLACE_CELL for a replacement, and PASS_CODE for a pass.
+ */
+struct ArchiveFormat {
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t tiles;
+        uint32_t cells;
+        uint8_t reserved[44];
+    };
+
+    struct Footer {
+        uint64_t indexOffset;
+        uint64_t games;
+        char magic[8];
+        uint8_t reserved[8];
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "file header must be 64 bytes");
+    static_assert(sizeof(Footer) == 32, "footer must be 32 bytes");
+
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t KIND_BITS = 6;
+    static constexpr size_t DEAL_BYTES =
+        (StandardRules::TILES * KIND_BITS + 7) / 8;
+    static constexpr uint16_t CELL_BITS = 10;
+    static constexpr uint16_t REPLACE_CELL = (1 << CELL_BITS) - 1;
+    static constexpr uint16_t PASS_CODE = UINT16_MAX;
+
+    static_assert(StandardRules::KINDS <= 1 << KIND_BITS,
+        "a kind must fit in KIND_BITS");
+    static_assert(StandardRules::CELLS < REPLACE_CELL,
+        "a cell must fit in CELL_BITS");
+
+    /**
+     * Get the two byte code of a move.
+     */
+    static uint16_t encode(const ArchivedMove& move);
+
+    /**
+     * Get the move a code stands for.
+     */
+    static ArchivedMove decode(uint16_t code);
+};
+
+/**
+ * @note
+ * Writes an archive from any number of threads. Each game is encoded on the
+ * thread adding it and only the copy into the write buffer holds the lock;
+ * the buffer goes to disk in large writes, and the index and footer once the
+ * archive is closed.
+ */
+class ArchiveWriter {
+public:
+    // the bytes buffered before they are written
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    /**
+     * Create an archive.
+     *
+     * @param fileName - the name of the file
+     * @throws runtime_error if the file cannot be created
+     */
+    explicit ArchiveWriter(const string& fileName);
+
+    /**
+     * Destructor to close the archive if it is still open.
+     */
+    ~ArchiveWriter();
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    /**
+     * Add a game.
+     *
+     * @param game - the game, with a full deal
+     * @throws invalid_argument if the game cannot be encoded
+     * @throws runtime_error if the file cannot be written
+     */
+    void add(const ArchivedGame& game);
+
+    /**
+     * Write the rest of the games, the index and the footer.
+     *
+     * @throws runtime_error if the file cannot be written
+     */
+    void close();
+
+    /**
+     * Get the number of games added so far.
+     */
+    size_t getGameCount() const;
+
+private:
+    /**
+     * Write out the buffer. The lock must be held.
+     */
+    void flush();
+
+    const string fileName;
+    int file;
+    uint64_t written;
+    vector<uint8_t> buffer;
+    vector<uint64_t> offsets;
+    mutable mutex lock;
+};
+
+/**
+ * @note
+ * A game in a mapped archive, read in place. Nothing is decoded until it is
+ * asked for, so a scan over moves never builds the game.
+ */
+class ArchiveEntry {
+public:
+    /**
+     * Read the fixed fields of a game.
+     *
+     * @param data,size - the bytes the game may take up
+     * @throws runtime_error if the game does not fit
+     */
+    ArchiveEntry(const uint8_t* data, size_t size);
+
+    /**
+     * Get the name of the player in a seat, 0 for the one moving first.
+     */
+    string getName(size_t seat) const;
+
+    /**
+     * Get the final score of the player in a seat.
+     */
+    size_t getScore(size_t seat) const;
+
+    size_t getMoveCount() const;
+
+    /**
+     * Get a move, from 0.
+     */
+    ArchivedMove getMove(size_t index) const;
+
+    /**
+     * Get the kind of a tile of the deal, from 0 for the front of the bag.
+     */
+    uint8_t getDealt(size_t index) const;
+
+    /**
+     * Set a game up as it was dealt, ready for its first move.
+     *
+     * @param manager - the manager to play the game in
+     */
+    void deal(GameManager& manager) const;
+
+    /**
+     * Make a move in a game, the outcome reported through its listener.
+     *
+     * @param manager - the game
+     * @param move - the move
+     */
+    static void play(GameManager& manager, const ArchivedMove& move);
+
+private:
+    array<const uint8_t*, 2> names;
+    array<uint8_t, 2> nameLengths;
+    array<uint16_t, 2> scores;
+    size_t moveCount;
+    const uint8_t* dealt;
+    const uint8_t* moves;
+};
+
+/**
+ * @note
+ * An archive mapped read-only into memory. Looking up a game reads one entry
+ * of the index, and reading games in order touches the file front to back.
+ */
+class ArchiveReader {
+public:
+    /**
+     * Map an archive.
+     *
+     * @param fileName - the name of the file
+     * @throws runtime_error if the file cannot be mapped or is not valid
+     */
+    explicit ArchiveReader(const string& fileName);
+
+    /**
+     * Destructor to unmap the file.
+     */
+    ~ArchiveReader();
+
+    ArchiveReader(const ArchiveReader&) = delete;
+    ArchiveReader& operator=(const ArchiveReader&) = delete;
+
+    size_t getGameCount() const;
+
+    /**
+     * Get a game.
+     *
+     * @param index - the game, from 0 in the order they were added
+     * @throws out_of_range if there is no such game
+     * @throws runtime_error if the game is not valid
+     */
+    ArchiveEntry getGame(size_t index) const;
+
+private:
+    const uint8_t* data;
+    size_t size;
+    uint64_t indexOffset;
+    size_t games;
+};
+
+#endif // !GAME_ARCHIVE_H
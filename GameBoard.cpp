@@ -1,11 +1,14 @@
 #include "GameBoard.h"
 #include "Constants.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 
 using std::left;
+using std::lock_guard;
 using std::right;
 using std::setw;
 using std::endl;
@@ -13,77 +16,287 @@ using std::string;
 using std::invalid_argument;
 using std::out_of_range;
 
-GameBoard::GameBoard() : tileCount(0) {
-    for (size_t i = 0; i < BOARD_LENGTH; ++i) {
-        board.push_back(vector<shared_ptr<Tile>>());
-        board.at(i).resize(BOARD_LENGTH, nullptr);
-    }
+template <class Rules>
+BasicGameBoard<Rules>::BasicGameBoard() : bounds{0, 0, 0, 0} {
+    for (KindCells& cells : kindCells)
+        cells.count = 0;
+}
+
+template <class Rules>
+BasicGameBoard<Rules>::RowCache::RowCache() { dirty.set(); }
+
+template <class Rules>
+BasicGameBoard<Rules>::RowCache::RowCache(const RowCache& other) {
+    lock_guard<mutex> guard(other.lock);
+    rows = other.rows;
+    dirty = other.dirty;
 }
 
-GameBoard::~GameBoard() {
-    for (size_t i = 0; i < BOARD_LENGTH; ++i)
-        board.at(i).clear();
+template <class Rules>
+BasicGameBoard<Rules>::~BasicGameBoard() {
+    for (size_t i = 0; i < Rules::BOARD_LENGTH; ++i)
+        board.at(i).fill(nullptr);
 }
 
-void GameBoard::placeTile(
+template <class Rules>
+void BasicGameBoard<Rules>::placeTile(
     const shared_ptr<Tile>& tile, size_t row, size_t column) {
-    if (row >= BOARD_LENGTH || column >= BOARD_LENGTH)
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH)
         throw out_of_range("invalid grid location for GameBoard::placeTile");
+    else if (board.at(row).at(column) != nullptr)
+        throw invalid_argument(
+            "occupied grid location for GameBoard::placeTile");
 
+    size_t kind = Rules::kindOf(*tile);
     board.at(row).at(column) = tile;
-    ++tileCount;
+    index.place(kind, row, column);
+    cache.dirty.set(row);
+
+    if (kind < Rules::KINDS && kindCells[kind].count < Rules::COPIES) {
+        KindCells& cells = kindCells[kind];
+        cells.cells[cells.count++] =
+            uint16_t(row * Rules::BOARD_LENGTH + column);
+    }
+
+    if (bounds.isEmpty()) {
+        bounds = {row, row + 1, column, column + 1};
+    } else {
+        bounds.top = std::min(bounds.top, row);
+        bounds.bottom = std::max(bounds.bottom, row + 1);
+        bounds.left = std::min(bounds.left, column);
+        bounds.right = std::max(bounds.right, column + 1);
+    }
 }
 
-shared_ptr<Tile> GameBoard::at(size_t row, size_t column) const {
-    if (row >= BOARD_LENGTH || column >= BOARD_LENGTH)
+template <class Rules>
+shared_ptr<Tile> BasicGameBoard<Rules>::at(size_t row, size_t column) const {
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH)
         throw out_of_range("invalid grid location for GameBoard::at");
 
     return board.at(row).at(column);
 }
 
-bool GameBoard::isEmpty() const { return tileCount == 0; }
+template <class Rules>
+Run BasicGameBoard<Rules>::runAt(size_t row, size_t column, Axis axis) const {
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH)
+        throw out_of_range("invalid grid location for GameBoard::runAt");
+
+    return index.runAt(row, column, axis);
+}
+
+template <class Rules>
+Run BasicGameBoard<Rules>::adjacentRun(
+    size_t row, size_t column, Axis axis) const {
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH)
+        throw out_of_range("invalid grid location for GameBoard::adjacentRun");
+
+    return index.adjacentRun(row, column, axis);
+}
+
+template <class Rules>
+bool BasicGameBoard<Rules>::acceptsAny(
+    typename LineTable<Rules>::KindMask kinds) const {
+    return index.acceptsAny(kinds);
+}
+
+template <class Rules>
+const LineIndex<Rules>& BasicGameBoard<Rules>::getIndex() const {
+    return index;
+}
+
+template <class Rules>
+bool BasicGameBoard<Rules>::isEmpty() const {
+    return index.getTileCount() == 0;
+}
+
+template <class Rules>
+const typename BasicGameBoard<Rules>::KindCells&
+BasicGameBoard<Rules>::cellsOf(size_t kind) const {
+    return kindCells[kind];
+}
+
+template <class Rules>
+size_t BasicGameBoard<Rules>::countOf(size_t kind) const {
+    return kindCells[kind].count;
+}
+
+template <class Rules>
+vector<size_t> BasicGameBoard<Rules>::cellsOfColour(size_t index) const {
+    vector<size_t> cells;
+    for (size_t shape = 0; shape < Rules::TYPES; ++shape) {
+        const KindCells& placed = kindCells[index * Rules::TYPES + shape];
+        cells.insert(cells.end(), placed.cells.begin(),
+            placed.cells.begin() + placed.count);
+    }
+
+    return cells;
+}
+
+template <class Rules>
+vector<size_t> BasicGameBoard<Rules>::cellsOfShape(size_t index) const {
+    vector<size_t> cells;
+    for (size_t colour = 0; colour < Rules::TYPES; ++colour) {
+        const KindCells& placed = kindCells[colour * Rules::TYPES + index];
+        cells.insert(cells.end(), placed.cells.begin(),
+            placed.cells.begin() + placed.count);
+    }
 
-ostream& operator<<(ostream& os, const GameBoard& gameBoard) {
-    // print the column header
+    return cells;
+}
+
+template <class Rules>
+BoardBounds BasicGameBoard<Rules>::getBounds(size_t margin) const {
+    if (bounds.isEmpty())
+        return bounds;
+
+    return {bounds.top - std::min(bounds.top, margin),
+        std::min(bounds.bottom + margin, Rules::BOARD_LENGTH),
+        bounds.left - std::min(bounds.left, margin),
+        std::min(bounds.right + margin, Rules::BOARD_LENGTH)};
+}
+
+template <class Rules>
+string BasicGameBoard<Rules>::formatRow(size_t row) const {
+    string formatted;
+    formatted.reserve(Rules::BOARD_LENGTH * 3 + 4);
+    formatted += (char)(row + ASCII_ALPHABET_BEGIN);
+    formatted += " |";
+
+    // only the columns the tiles span can hold one
+    for (size_t j = 0; j < Rules::BOARD_LENGTH; ++j) {
+        const shared_ptr<Tile>& tile = j >= bounds.left && j < bounds.right
+            ? board.at(row).at(j) : nullptr;
+        if (tile) {
+            formatted += tile->getColour();
+            formatted += std::to_string(tile->getShape());
+        } else {
+            formatted += "  ";
+        }
+        formatted += "|";
+    }
+
+    formatted += "\n";
+    return formatted;
+}
+
+template <class Rules>
+void BasicGameBoard<Rules>::printChanges(ostream& os, size_t top) const {
+    lock_guard<mutex> guard(cache.lock);
+    array<string, Rules::BOARD_LENGTH>& rows = cache.rows;
+    bitset<Rules::BOARD_LENGTH>& dirty = cache.dirty;
+
+    // save the cursor, move to each changed cell in turn and restore it
+    os << "\0337";
+    for (size_t i = 0; i < Rules::BOARD_LENGTH; ++i) {
+        if (!dirty.test(i))
+            continue;
+
+        string formatted = formatRow(i);
+        size_t line = top + 2 + i;
+        if (formatted.size() != rows.at(i).size()) {
+            // a row never printed is drawn whole
+            os << "\033[" << line << ";1H"
+               << formatted.substr(0, formatted.size() - 1);
+        } else {
+            // each cell is two characters after the row's label and border
+            for (size_t j = 0; j < Rules::BOARD_LENGTH; ++j) {
+                size_t offset = 3 + 3 * j;
+                if (formatted.compare(offset, 2, rows.at(i), offset, 2) != 0) {
+                    os << "\033[" << line << ";" << offset + 1 << "H"
+                       << formatted.substr(offset, 2);
+                }
+            }
+        }
+
+        rows.at(i) = formatted;
+    }
+    dirty.reset();
+    os << "\0338" << std::flush;
+}
+
+template <class Rules>
+void BasicGameBoard<Rules>::printRegion(
+    ostream& os, const BoardBounds& region) const {
     os << left << setw(3) << " ";
-    for (int i = 0; i < BOARD_LENGTH; ++i) os << setw(3) << i;
+    for (size_t i = region.left; i < region.right; ++i) os << setw(3) << i;
     os << endl;
 
-    // print the line under the column header
     os << setw(2) << " ";
-    for (int i = 0; i < BOARD_LENGTH * 3 + 1; ++i) os << "-";
+    for (size_t i = 0; i < (region.right - region.left) * 3 + 1; ++i)
+        os << "-";
     os << endl;
 
-    // print each row
-    for (int i = 0; i < BOARD_LENGTH; ++i) {
-        os << (char)(i + ASCII_ALPHABET_BEGIN) << " |";
-
-        for (int j = 0; j < BOARD_LENGTH; ++j) {
-            if (gameBoard.board.at(i).at(j)) os << *gameBoard.board.at(i).at(j);
-            else os << "  ";
-            os << "|";
+    // a cell's two characters and the border after it are three of a row
+    lock_guard<mutex> guard(cache.lock);
+    for (size_t i = region.top; i < region.bottom; ++i) {
+        if (cache.dirty.test(i)) {
+            cache.rows.at(i) = formatRow(i);
+            cache.dirty.reset(i);
         }
-
+        const string& row = cache.rows.at(i);
+        os.write(row.data(), 3);
+        os.write(row.data() + 3 + 3 * region.left,
+            3 * (region.right - region.left));
         os << endl;
     }
+}
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicGameBoard<Rules>& gameBoard) {
+    // the column header and the line under it never change
+    static const string header = [] {
+        std::ostringstream formatted;
+        formatted << left << setw(3) << " ";
+        for (size_t i = 0; i < Rules::BOARD_LENGTH; ++i)
+            formatted << setw(3) << i;
+        formatted << "\n" << setw(2) << " ";
+        for (size_t i = 0; i < Rules::BOARD_LENGTH * 3 + 1; ++i)
+            formatted << "-";
+        formatted << "\n";
+        return formatted.str();
+    }();
+    os << left << header;
+
+    // print each row, formatting only those placed in since the last time
+    typename BasicGameBoard<Rules>::RowCache& cache = gameBoard.cache;
+    lock_guard<mutex> guard(cache.lock);
+    for (size_t i = 0; i < Rules::BOARD_LENGTH; ++i) {
+        if (cache.dirty.test(i))
+            cache.rows.at(i) = gameBoard.formatRow(i);
+        os << cache.rows.at(i);
+    }
+    cache.dirty.reset();
 
     return os;
 }
 
-ofstream& operator<<(ofstream& ofs, const GameBoard& gameBoard) {
+template <class Rules>
+void BasicGameBoard<Rules>::save(ostream& os) const {
     bool first = true;
-    for (unsigned int i = 0; i < BOARD_LENGTH; ++i) {
-        for (unsigned int j = 0; j < BOARD_LENGTH; ++j) {
-            shared_ptr<Tile> tile = gameBoard.board.at(i).at(j);
+    for (size_t i = bounds.top; i < bounds.bottom; ++i) {
+        for (size_t j = bounds.left; j < bounds.right; ++j) {
+            shared_ptr<Tile> tile = board.at(i).at(j);
             if (tile != nullptr) {
                 // print each row and column in specified "Tile@Location" format
-                ofs << (first ? "" : ", ") << *tile << "@"
-                    << (char)(i + ASCII_ALPHABET_BEGIN) << j;
+                os << (first ? "" : ", ") << *tile << "@"
+                   << (char)(i + ASCII_ALPHABET_BEGIN) << j;
 
                 first = false;
             }
         }
     }
+}
 
+template <class Rules>
+ofstream& operator<<(ofstream& ofs, const BasicGameBoard<Rules>& gameBoard) {
+    gameBoard.save(ofs);
     return ofs;
 }
+
+template class BasicGameBoard<StandardRules>;
+template ostream& operator<<(ostream&, const BasicGameBoard<StandardRules>&);
+template ofstream& operator<<(ofstream&, const BasicGameBoard<StandardRules>&);
+
+template class BasicGameBoard<ExtendedRules>;
+template ostream& operator<<(ostream&, const BasicGameBoard<ExtendedRules>&);
+template ofstream& operator<<(ofstream&, const BasicGameBoard<ExtendedRules>&);
@@ -1,29 +1,82 @@
-
 #ifndef GAME_BOARD_H
 #define GAME_BOARD_H
 
 #include "Tile.h"
+#include "LineIndex.h"
 
+#include <array>
+#include <bitset>
 #include <fstream>
 #include <memory>
+#include <mutex>
+#include <cstdint>
+#include <string>
 #include <vector>
 
-using std::vector;
+using std::array;
+using std::bitset;
 using std::shared_ptr;
 using std::make_shared;
+using std::mutex;
 using std::ofstream;
+using std::string;
+using std::vector;
+
+template <class Rules>
+class BasicGameBoard;
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicGameBoard<Rules>& board);
 
-class GameBoard {
+template <class Rules>
+ofstream& operator<<(ofstream& ofs, const BasicGameBoard<Rules>& board);
+
+/**
+ * A rectangle of the board, the rows from top up to but not including bottom
+ * and the columns from left up to but not including right. An empty board
+ * is bounded by an empty rectangle.
+ */
+struct BoardBounds {
+    size_t top;
+    size_t bottom;
+    size_t left;
+    size_t right;
+
+    bool isEmpty() const { return top >= bottom; }
+};
+
+/**
+ * @note
+ * The board keeps each row as it was last printed and marks a row dirty when
+ * a tile is placed in it, so printing only formats the rows placed in since.
+ * Printing a board changes its cache, which is locked while it is printed,
+ * so a board shared with a snapshot can be printed from any thread. A copy
+ * of a board starts from the original's cache.
+ * The board also tracks the rows and columns its tiles span, so scans over
+ * the tiles only cover the part of the board that has been played on, and
+ * the cells each kind sits in, so finding a kind takes no scan at all.
+ */
+template <class Rules>
+class BasicGameBoard {
 public:
     /**
-     * Construct the board with a 2d vector of default values.
+     * The cells the copies of a kind sit in, each row * BOARD_LENGTH +
+     * column, in the order they were placed.
      */
-    GameBoard();
+    struct KindCells {
+        array<uint16_t, Rules::COPIES> cells;
+        uint8_t count;
+    };
+
+    /**
+     * Construct the board with a 2d array of default values.
+     */
+    BasicGameBoard();
 
     /**
      * Destructor to free up all the tiles placed.
      */
-    ~GameBoard();
+    ~BasicGameBoard();
 
     /**
      * Place a tile on the board at the given location.
@@ -41,6 +94,42 @@ public:
      */
     shared_ptr<Tile> at(size_t row, size_t column) const;
 
+    /**
+     * Get the run through an occupied cell.
+     *
+     * @param row,column - the location
+     * @param axis - the axis of the run
+     * @return the run, of length 0 if the cell is empty
+     */
+    Run runAt(size_t row, size_t column, Axis axis) const;
+
+    /**
+     * Get the runs either side of an empty cell taken together, which is the
+     * line a tile placed there would join less the tile itself.
+     *
+     * @param row,column - the location
+     * @param axis - the axis of the runs
+     * @return the joined run, of length 0 if there are no adjacent tiles
+     */
+    Run adjacentRun(size_t row, size_t column, Axis axis) const;
+
+    /**
+     * Query whether a tile of any of the given kinds could be placed, only
+     * the empty cells next to a tile are checked.
+     *
+     * @param kinds - a mask with a bit set for each kind
+     * @return true if some kind fits some cell, any kind fits an empty board
+     */
+    bool acceptsAny(typename LineTable<Rules>::KindMask kinds) const;
+
+    /**
+     * Get the index of the kinds, runs and frontier of the board, which
+     * validates and scores placements without exceptions.
+     *
+     * @return a reference to the index
+     */
+    const LineIndex<Rules>& getIndex() const;
+
     /**
      * Query whether the board is empty.
      *
@@ -48,13 +137,75 @@ public:
      */
     bool isEmpty() const;
 
+    /**
+     * Get the smallest rectangle holding every tile, grown by a margin on
+     * each side as far as the edges of the board. A margin of one takes in
+     * every cell a tile could be placed in.
+     *
+     * @param margin - the cells to add on each side
+     * @return the rectangle, empty if the board is
+     */
+    BoardBounds getBounds(size_t margin = 0) const;
+
+    /**
+     * Get the cells a kind sits in. Copies beyond those the rules allow,
+     * which only a doctored save can place, are not kept.
+     *
+     * @param kind - the kind, which must be below Rules::KINDS
+     * @return the cells
+     */
+    const KindCells& cellsOf(size_t kind) const;
+
+    /**
+     * Get the number of copies of a kind on the board.
+     *
+     * @param kind - the kind, which must be below Rules::KINDS
+     */
+    size_t countOf(size_t kind) const;
+
+    /**
+     * Get the cells the tiles of a colour, or of a shape, sit in.
+     *
+     * @param index - the index of the colour or shape, as Rules::colourAt
+     * and Rules::shapeAt take
+     * @return the cells, each row * BOARD_LENGTH + column, kind by kind
+     */
+    vector<size_t> cellsOfColour(size_t index) const;
+    vector<size_t> cellsOfShape(size_t index) const;
+
+    /**
+     * Write the placed tiles in the "Tile@Location" save format.
+     *
+     * @param os - a reference to the output stream
+     */
+    void save(ostream& os) const;
+
+    /**
+     * Redraw with ANSI escape sequences, on a terminal the board was last
+     * printed to in full, only the cells that have changed since it was
+     * printed. The cursor is put back where it was.
+     *
+     * @param os - a reference to the output stream
+     * @param top - the terminal line the column header is on, from 1
+     */
+    void printChanges(ostream& os, size_t top) const;
+
+    /**
+     * Print part of the board as the output stream operator prints all of
+     * it, with the labels of only the rows and columns shown.
+     *
+     * @param os - a reference to the output stream
+     * @param bounds - the part of the board, which must not be empty
+     */
+    void printRegion(ostream& os, const BoardBounds& bounds) const;
+
     /**
      * Overloaded output stream operator for easy printing.
      *
      * @param os - a reference to the output stream
      * @param board - a reference to the board to be printed
      */
-    friend ostream& operator<<(ostream& os, const GameBoard& board);
+    friend ostream& operator<< <>(ostream& os, const BasicGameBoard& board);
 
     /**
      * Overloaded file output stream operator for printing to a file.
@@ -62,11 +213,50 @@ public:
      * @param ofs - a reference to the file output stream
      * @param board - a reference to the board to be printed
      */
-    friend ofstream& operator<<(ofstream& ofs, const GameBoard& board);
+    friend ofstream& operator<< <>(ofstream& ofs, const BasicGameBoard& board);
 
 private:
-    size_t tileCount;
-    vector<vector<shared_ptr<Tile>>> board;
+    /**
+     * Each row as it was last printed and the rows placed in since, with
+     * the lock printing holds.
+     */
+    struct RowCache {
+        array<string, Rules::BOARD_LENGTH> rows;
+        bitset<Rules::BOARD_LENGTH> dirty;
+        mutable mutex lock;
+
+        /**
+         * Construct a cache with every row still to be formatted.
+         */
+        RowCache();
+
+        /**
+         * Copy constructor, copies the rows under the other cache's lock.
+         */
+        RowCache(const RowCache& other);
+
+        RowCache& operator=(const RowCache&) = delete;
+    };
+
+    /**
+     * Format a row for printing, with the line break.
+     *
+     * @param row - the row
+     * @return the formatted row
+     */
+    string formatRow(size_t row) const;
+
+    array<array<shared_ptr<Tile>, Rules::BOARD_LENGTH>, Rules::BOARD_LENGTH>
+        board;
+    LineIndex<Rules> index;
+
+    // the rows and columns the tiles span, empty with no tiles
+    BoardBounds bounds;
+    array<KindCells, Rules::KINDS> kindCells;
+
+    mutable RowCache cache;
 };
 
+typedef BasicGameBoard<StandardRules> GameBoard;
+
 #endif // !GAME_BOARD_H
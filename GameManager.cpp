@@ -1,15 +1,16 @@
 #include "GameManager.h"
-#include "IOHandler.h"
-#include "Constants.h"
+#include "LineTable.h"
+#include "Stats.h"
+
+#include <random>
 
 using std::invalid_argument;
 using std::out_of_range;
+using std::random_device;
 
-shared_ptr<TileBag> GameManager::bag = nullptr;
-shared_ptr<Player> GameManager::player1 = nullptr;
-shared_ptr<Player> GameManager::player2 = nullptr;
-shared_ptr<Player> GameManager::currentPlayer = nullptr;
-shared_ptr<GameBoard> GameManager::board = nullptr;
+template <class Rules>
+BasicGameManager<Rules>::BasicGameManager(size_t chunkSize)
+    : chunkSize(chunkSize) {}
 
 /**
  * Initialise the board, tilebag and the players for the game.
@@ -17,30 +18,60 @@ shared_ptr<GameBoard> GameManager::board = nullptr;
  * @param player1Name - name of the first player
  * @param player2name - name of the second player
  */
-void GameManager::beginGame(
+template <class Rules>
+void BasicGameManager<Rules>::beginGame(
     const string& player1Name, const string& player2Name) {
-    bag = make_shared<TileBag>();
+    random_device device;
+    beginGame(player1Name, player2Name,
+        (uint64_t(device()) << 32) | device());
+}
+
+/**
+ * Initialise the board, tilebag and the players for a game that is dealt the
+ * same way every time for the same seed.
+ *
+ * @param player1Name - name of the first player
+ * @param player2name - name of the second player
+ * @param seed - the seed the bag is shuffled with
+ */
+template <class Rules>
+void BasicGameManager<Rules>::beginGame(
+    const string& player1Name, const string& player2Name, uint64_t seed) {
+    // every allocation for the game comes from its arena
+    arena = make_shared<Arena>(chunkSize);
+    bag = allocate_shared<Bag>(ArenaAllocator<Bag>(arena), arena);
     bag->fill();
-    bag->shuffle();
+    bag->shuffle(seed);
 
-    player1 = make_shared<Player>(player1Name, bag->getHand());
-    player2 = make_shared<Player>(player2Name, bag->getHand());
+    ArenaAllocator<Player> allocator(arena);
+    player1 = allocate_shared<Player>(allocator, player1Name, bag->getHand());
+    player2 = allocate_shared<Player>(allocator, player2Name, bag->getHand());
     currentPlayer = player1;
 
-    board = make_shared<GameBoard>();
+    board = allocate_shared<Board>(ArenaAllocator<Board>(arena));
+    player1->getUnseen().recount(*board, *player1->getHand());
+    player2->getUnseen().recount(*board, *player2->getHand());
+    lastSnapshot.reset();
 }
 
-void GameManager::loadGame(const shared_ptr<Player>& player1,
-    const shared_ptr<Player>& player2, const shared_ptr<TileBag>& loadedBag,
-    const shared_ptr<GameBoard>& loadedBoard,
-    const shared_ptr<Player>& currentPlayer) {
+template <class Rules>
+void BasicGameManager<Rules>::loadGame(const shared_ptr<Player>& player1,
+    const shared_ptr<Player>& player2, const shared_ptr<Bag>& loadedBag,
+    const shared_ptr<Board>& loadedBoard,
+    const shared_ptr<Player>& currentPlayer,
+    const shared_ptr<Arena>& loadedArena) {
 
+    arena = loadedArena;
     bag = loadedBag;
     board = loadedBoard;
 
-    GameManager::player1 = player1;
-    GameManager::player2 = player2;
-    GameManager::currentPlayer = currentPlayer;
+    this->player1 = player1;
+    this->player2 = player2;
+    this->currentPlayer = currentPlayer;
+    lastSnapshot.reset();
+
+    player1->getUnseen().recount(*board, *player1->getHand());
+    player2->getUnseen().recount(*board, *player2->getHand());
 }
 
 /**
@@ -49,49 +80,66 @@ void GameManager::loadGame(const shared_ptr<Player>& player1,
  * @param colour,shape - the tile attributes
  * @param row,column - the specified grid location
  */
-void GameManager::placeTile(Colour colour, Shape shape, size_t row, size_t column) {
+template <class Rules>
+void BasicGameManager<Rules>::placeTile(
+    Colour colour, Shape shape, size_t row, size_t column) {
     string message = "Tile placed successfully.";
     State state = PLACE_SUCCESS;
 
     try {
+        STATS_TIME(TIMER_VALIDATE);
         Tile tile(colour, shape);
         if (!isTileInHand(tile)) {
             message = "The specified tile is not present in hand.";
+            STATS_COUNT(REJECTED_NOT_IN_HAND);
             throw invalid_argument("");
         } else if (!isGridLocationEmpty(row, column)) {
             message =
                 "A tile is already present in the provided grid location.";
+            STATS_COUNT(REJECTED_OCCUPIED);
             throw invalid_argument("");
         }
 
         Lines lines = getAdjacentLines(tile, row, column);
         if (!board->isEmpty() && !hasAdjacentTile(tile, lines)) {
             message = "No adjacent tile to form line.";
+            STATS_COUNT(REJECTED_NO_ADJACENT);
             throw invalid_argument("");
         } else if (!isTileValidOnLine(tile, lines)) {
             message = "Tile violates line rules.";
+            STATS_COUNT(REJECTED_LINE_RULES);
             throw invalid_argument("");
         }
 
+        STATS_STOP();
+        copyOnWrite();
+
         // score for the first round
         if (board->isEmpty())
             currentPlayer->setScore(1);
 
-        board->placeTile(currentPlayer->getHand()->playTile(tile), row, column);
+        shared_ptr<Tile> played = currentPlayer->getHand()->playTile(tile);
+        board->placeTile(played, row, column);
+        player1->getUnseen().tilePlaced(*played, currentPlayer == player1);
+        player2->getUnseen().tilePlaced(*played, currentPlayer == player2);
+
         if (!bag->getTiles()->isEmpty()) {
-            currentPlayer->getHand()->addTile(bag->getTiles()->at(FIRST_POSITION));
+            shared_ptr<Tile> drawn = bag->getTiles()->front();
+            currentPlayer->getHand()->addTile(drawn);
+            currentPlayer->getUnseen().tileDrawn(*drawn);
             bag->getTiles()->removeFront();
         }
 
-        updateScore(lines);
-        GameManager::switchPlayer();
+        updateScore(*played, lines);
+        STATS_COUNT(MOVES_ACCEPTED);
+        switchPlayer();
     } catch (...) {
         state = PLACE_FAILURE;
     }
 
-    IOHandler::notify(message, state);
+    notify(message, state);
     if (hasGameEnded())
-        IOHandler::notify("", GAME_OVER);
+        notify("", GAME_OVER);
 }
 
 /**
@@ -99,11 +147,13 @@ void GameManager::placeTile(Colour colour, Shape shape, size_t row, size_t colum
  *
  * @param colour,shape - the tile attributes
  */
-void GameManager::replaceTile(Colour colour, Shape shape) {
+template <class Rules>
+void BasicGameManager<Rules>::replaceTile(Colour colour, Shape shape) {
     string message = "Tile replaced successfully.";
     State state = REPLACE_SUCCESS;
 
     try {
+        STATS_TIME(TIMER_VALIDATE);
         Tile tile(colour, shape);
         if (!isTileInHand(tile)) {
             message = "The specified tile is not present in hand.";
@@ -114,23 +164,31 @@ void GameManager::replaceTile(Colour colour, Shape shape) {
         }
 
         if (!bag->getTiles()->isEmpty()) {
-            currentPlayer->getHand()->replaceTile(tile, *bag);
-            GameManager::switchPlayer();
+            STATS_STOP();
+            copyOnWrite();
+            shared_ptr<Tile> drawn =
+                currentPlayer->getHand()->replaceTile(tile, *bag);
+            currentPlayer->getUnseen().tileReturned(tile);
+            currentPlayer->getUnseen().tileDrawn(*drawn);
+            STATS_COUNT(REPLACES_ACCEPTED);
+            switchPlayer();
         } else {
             message = "No more tiles remain to be replaced.";
             throw out_of_range("");
         }
     } catch (...) {
         state = REPLACE_FAILURE;
+        STATS_COUNT(REPLACES_REJECTED);
     }
 
-    IOHandler::notify(message, state);
+    notify(message, state);
 }
 
 /**
  * Switch player at the end of a round.
  */
-void GameManager::switchPlayer() {
+template <class Rules>
+void BasicGameManager<Rules>::switchPlayer() {
     currentPlayer = (*currentPlayer == *player1) ? player2 : player1;
 }
 
@@ -139,7 +197,8 @@ void GameManager::switchPlayer() {
  *
  * @param row,column - the specified grid location
  */
-bool GameManager::isGridLocationEmpty(size_t row, size_t column) {
+template <class Rules>
+bool BasicGameManager<Rules>::isGridLocationEmpty(size_t row, size_t column) {
     return board->at(row, column) == nullptr;
 }
 
@@ -148,62 +207,22 @@ bool GameManager::isGridLocationEmpty(size_t row, size_t column) {
  *
  * @param tile - the tile to be checked
  */
-bool GameManager::isTileInHand(const Tile& tile) {
-    return currentPlayer->getHand()->getTiles()->contains(tile);
+template <class Rules>
+bool BasicGameManager<Rules>::isTileInHand(const Tile& tile) {
+    return currentPlayer->getHand()->hasTile(tile);
 }
 
 /**
  * Gets the adjacent lines formed by the tile if placed at the specified
- * location.
+ * location, read from the board's run index without traversing the lines.
  *
- * @return Lines (pair<LinkedList, LinkedList) for the horizontal and vertical
- * lines
+ * @return Lines (pair<Run, Run>) for the horizontal and vertical lines
  * */
-Lines GameManager::getAdjacentLines(const Tile& tile, size_t row, size_t column) {
-    Lines lines = make_pair(LinkedList{}, LinkedList{});
-
-    size_t currentRow = row;
-    size_t currentColumn = column;
-    int currentDirection = UP;
-    bool allDirectionTraversed = false;
-
-    // only traverse as many times as there are tiles in all directions
-    while (!allDirectionTraversed) {
-        if (currentDirection == UP)
-            --currentRow;
-        else if (currentDirection == DOWN)
-            ++currentRow;
-        else if (currentDirection == LEFT)
-            --currentColumn;
-        else if (currentDirection == RIGHT)
-            ++currentColumn;
-
-        try {
-            shared_ptr<Tile> other = board->at(currentRow, currentColumn);
-
-            /*
-             * if location is empty (nullptr), proceed to traverse a different
-             * direction else keep track of traversed tiles
-             */
-            if (other != nullptr) {
-                if (currentDirection == UP || currentDirection == DOWN)
-                    lines.second.addBack(other);
-                else
-                    lines.first.addBack(other);
-            } else {
-                throw out_of_range("");
-            }
-        }
-        // exception may be thrown by board if the coordinates are out of bounds
-        catch (out_of_range& exception) {
-            currentRow = row;
-            currentColumn = column;
-            ++currentDirection;
-            allDirectionTraversed = currentDirection > RIGHT;
-        }
-    }
-
-    return lines;
+template <class Rules>
+Lines BasicGameManager<Rules>::getAdjacentLines(
+    const Tile& tile, size_t row, size_t column) {
+    return make_pair(board->adjacentRun(row, column, HORIZONTAL),
+        board->adjacentRun(row, column, VERTICAL));
 }
 
 /**
@@ -214,112 +233,189 @@ Lines GameManager::getAdjacentLines(const Tile& tile, size_t row, size_t column)
  * @param lines - the horizontal and vertical lines
  * @return boolean indicating whether the tile has adjacent neighbors
  */
-bool GameManager::hasAdjacentTile(const Tile& tile, const Lines& lines) {
-    return !lines.first.isEmpty() || !lines.second.isEmpty();
+template <class Rules>
+bool BasicGameManager<Rules>::hasAdjacentTile(
+    const Tile& tile, const Lines& lines) {
+    return lines.first.length != 0 || lines.second.length != 0;
 }
 
 /**
  * Check if the tile being placed violate the following rules.
- * - No more than 6 tiles per line.
+ * - No more than Rules::MAX_LINE_SIZE tiles per line.
  * - No same tile more than once per line.
  * - Tile has either same colour or shape with both the horizontal and vertical
  *   lines.
+ * Each line's descriptor is extended by the tile through the line table,
+ * which maps any line breaking a rule to ILLEGAL.
  *
  * @param tile - the tile to be placed
  * @param lines - the horizontal and vertical lines
  * @return boolean indicating whether the tile can be placed on line
  */
-bool GameManager::isTileValidOnLine(const Tile& tile, const Lines& lines) {
-    const LinkedList& horizontalTiles = lines.first;
-    const LinkedList& verticalTiles = lines.second;
-
-    bool tileUnique =
-        !horizontalTiles.contains(tile) && !verticalTiles.contains(tile);
-
-    /*
-     * check whether tile shares similarity with the other tiles on both the
-     * horizontal and vertical lines, is only traversed as long as one of the
-     * similarities remain, if more than 2 comparisons are made and conditions
-     * still hold then no further iteration is made as the tile cannot have
-     * dissimilarities any longer, the large number of conditions are there to
-     * ensure that the algorithm is as efficient as could be
-     */
-    bool hasSameColourAsLine = true;
-    bool hasSameShapeAsLine = true;
-
-    for (size_t i = 0; i < horizontalTiles.size() &&
-         (hasSameColourAsLine || hasSameShapeAsLine) && i < 2;
-         ++i) {
-        hasSameColourAsLine &= tile.hasSameColour(*horizontalTiles.at(i));
-        hasSameShapeAsLine &= tile.hasSameShape(*horizontalTiles.at(i));
-    }
-
-    bool matchHorizontalLine = hasSameColourAsLine || hasSameShapeAsLine;
-    hasSameColourAsLine = true;
-    hasSameShapeAsLine = true;
-
-    // only iterate if the tile matched the horizontal line above
-    for (size_t i = 0; i < verticalTiles.size() && matchHorizontalLine &&
-         (hasSameColourAsLine || hasSameShapeAsLine) && i < 2;
-         ++i) {
-        hasSameColourAsLine &= tile.hasSameColour(*verticalTiles.at(i));
-        hasSameShapeAsLine &= tile.hasSameShape(*verticalTiles.at(i));
-    }
-
-    bool matchVerticalLine = hasSameColourAsLine || hasSameShapeAsLine;
-
-    return tileUnique && matchHorizontalLine && matchVerticalLine &&
-        horizontalTiles.size() < MAX_LINE_SIZE &&
-        verticalTiles.size() < MAX_LINE_SIZE;
+template <class Rules>
+bool BasicGameManager<Rules>::isTileValidOnLine(
+    const Tile& tile, const Lines& lines) {
+    typedef LineTable<Rules> Table;
+    size_t kind = Rules::kindOf(tile);
+
+    return Table::extend(lines.first.descriptor, kind) != Table::ILLEGAL &&
+        Table::extend(lines.second.descriptor, kind) != Table::ILLEGAL;
 }
 
 /**
  * Update the score for a round based on the formed lines.
  *
+ * @param tile - the tile placed
  * @param lines - the horizontal and vertical lines
  */
-void GameManager::updateScore(const Lines& lines) {
+template <class Rules>
+void BasicGameManager<Rules>::updateScore(
+    const Tile& tile, const Lines& lines) {
+    typedef LineTable<Rules> Table;
+    STATS_TIME(TIMER_SCORE);
+    size_t kind = Rules::kindOf(tile);
+    bool horizontalQwirkle =
+        Table::isQwirkle(Table::extend(lines.first.descriptor, kind));
+    bool verticalQwirkle =
+        Table::isQwirkle(Table::extend(lines.second.descriptor, kind));
     size_t horizontalScore =
-        lines.first.isEmpty() ? 0 : lines.first.size() + 1;
+        lines.first.length == 0 ? 0 : lines.first.length + 1;
     size_t verticalScore =
-        lines.second.isEmpty() ? 0 : lines.second.size() + 1;
+        lines.second.length == 0 ? 0 : lines.second.length + 1;
 
     // qwirkle is printed twice if it happens twice on the same move
-    if (horizontalScore == MAX_LINE_SIZE) {
-        IOHandler::notify("QWIRKLE!!!", QWIRKLE);
+    if (horizontalQwirkle) {
+        STATS_COUNT(QWIRKLES);
+        notify("QWIRKLE!!!", QWIRKLE);
     }
-    if (verticalScore == MAX_LINE_SIZE) {
-        IOHandler::notify("QWIRKLE!!!", QWIRKLE);
+    if (verticalQwirkle) {
+        STATS_COUNT(QWIRKLES);
+        notify("QWIRKLE!!!", QWIRKLE);
     }
 
     // bonus points for emptying hand or scoring qwirkle
     int bonusCount = 0;
     if (player1->getHand()->getTiles()->isEmpty())
         ++bonusCount;
-    if (horizontalScore == MAX_LINE_SIZE)
+    if (horizontalQwirkle)
         ++bonusCount;
-    if (verticalScore == MAX_LINE_SIZE)
+    if (verticalQwirkle)
         ++bonusCount;
 
     currentPlayer->setScore(currentPlayer->getScore()
-        + horizontalScore + verticalScore + SCORE_BONUS * bonusCount);
+        + horizontalScore + verticalScore + Rules::SCORE_BONUS * bonusCount);
+}
+
+/**
+ * Check if conditions hold for game ending: the bag is empty and either a
+ * player has emptied their hand or neither player can place any tile.
+ */
+template <class Rules>
+bool BasicGameManager<Rules>::hasGameEnded() {
+    return bag->getTiles()->isEmpty() &&
+        (player1->getHand()->getTiles()->isEmpty() ||
+         player2->getHand()->getTiles()->isEmpty() || isStalemate());
 }
 
 /**
- * Check if conditions hold for game ending.
+ * Check that no tile in either hand fits any cell next to a tile, which with
+ * an empty bag means no move is left. Only the board's frontier is checked,
+ * against the kinds both hands hold together.
  */
-bool GameManager::hasGameEnded() {
-    return (player1->getHand()->getTiles()->isEmpty() ||
-       player2->getHand()->getTiles()->isEmpty()) && bag->getTiles()->isEmpty();
+template <class Rules>
+bool BasicGameManager<Rules>::isStalemate() {
+    return !board->acceptsAny(player1->getHand()->getKindMask() |
+        player2->getHand()->getKindMask());
 }
 
 /**
  * Resets the data structures for a new game.
  */
-void GameManager::resetGame() {
+template <class Rules>
+void BasicGameManager<Rules>::resetGame() {
     board.reset();
     bag.reset();
     player1.reset();
     player2.reset();
     currentPlayer.reset();
+    lastSnapshot.reset();
+
+    // the arena's chunks are released once the last tile and node are gone
+    arena.reset();
+}
+
+/**
+ * Take an immutable snapshot of the game in O(1), the state is shared with the
+ * snapshot until the next mutation copies it. Snapshots taken between two
+ * mutations are the same snapshot.
+ *
+ * @return a pointer to the snapshot
+ */
+template <class Rules>
+shared_ptr<const BasicGameSnapshot<Rules>>
+BasicGameManager<Rules>::snapshot() {
+    shared_ptr<const Snapshot> shared = lastSnapshot.lock();
+    if (!shared) {
+        shared = make_shared<Snapshot>(board, bag, player1, player2,
+            currentPlayer);
+        lastSnapshot = shared;
+    }
+
+    return shared;
+}
+
+/**
+ * Return the game to the state of a snapshot taken earlier in it. The state
+ * is copied out of the snapshot, which is left as it was.
+ *
+ * @param snapshot - the snapshot to return to
+ */
+template <class Rules>
+void BasicGameManager<Rules>::restore(const Snapshot& snapshot) {
+    bool firstIsCurrent =
+        snapshot.getCurrentPlayer() == snapshot.getPlayer1();
+    // the copies come from the heap, the arena would keep them until the
+    // game ends once they are replaced
+    board = make_shared<Board>(*snapshot.getBoard());
+    bag = make_shared<Bag>(*snapshot.getBag(), nullptr);
+    player1 = make_shared<Player>(*snapshot.getPlayer1(), nullptr);
+    player2 = make_shared<Player>(*snapshot.getPlayer2(), nullptr);
+    currentPlayer = firstIsCurrent ? player1 : player2;
+    lastSnapshot.reset();
+}
+
+/**
+ * Copy the board, bag and players if they are shared with a live snapshot,
+ * must be called before any of them is mutated. The tiles themselves are
+ * immutable and remain shared between the copies.
+ */
+template <class Rules>
+void BasicGameManager<Rules>::copyOnWrite() {
+    if (lastSnapshot.expired())
+        return;
+
+    bool firstIsCurrent = currentPlayer == player1;
+    // as with restore, the copies are freed once the snapshot and the game
+    // have both moved on from them
+    board = make_shared<Board>(*board);
+    bag = make_shared<Bag>(*bag, nullptr);
+    player1 = make_shared<Player>(*player1, nullptr);
+    player2 = make_shared<Player>(*player2, nullptr);
+    currentPlayer = firstIsCurrent ? player1 : player2;
+    lastSnapshot.reset();
 }
+
+/**
+ * Report the outcome of a move to the listener, if there is one.
+ *
+ * @param message - the message describing the outcome
+ * @param state - the outcome
+ */
+template <class Rules>
+void BasicGameManager<Rules>::notify(const string& message, State state) {
+    if (listener)
+        listener(message, state);
+}
+
+template class BasicGameManager<StandardRules>;
+template class BasicGameManager<ExtendedRules>;
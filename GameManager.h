@@ -2,66 +2,108 @@
 #ifndef GAME_MANAGER_H
 #define GAME_MANAGER_H
 
-#define UP 0
-#define DOWN 1
-#define LEFT 2
-#define RIGHT 3
-
-#include "GameBoard.h"
-#include "Player.h"
+#include "GameSnapshot.h"
 
+#include <functional>
 #include <utility>
 
+using std::function;
 using std::pair;
 using std::make_pair;
+using std::weak_ptr;
 
-typedef pair<LinkedList, LinkedList> Lines;
+// the runs a placement would join along the horizontal and vertical axes
+typedef pair<Run, Run> Lines;
 
+// the values are the codes of the bot protocol and must not change
 enum State {
-    PLACE_SUCCESS,
-    PLACE_FAILURE,
-    REPLACE_SUCCESS,
-    REPLACE_FAILURE,
-    GAME_OVER,
-    QWIRKLE
+    PLACE_SUCCESS = 0,
+    PLACE_FAILURE = 1,
+    REPLACE_SUCCESS = 2,
+    REPLACE_FAILURE = 3,
+    GAME_OVER = 4,
+    QWIRKLE = 5
 };
 
-class GameManager {
+/**
+ * @note
+ * Runs a game under the given rule set. The outcome of each move is reported
+ * through the listener, so the manager does not depend on how it is shown.
+ * Every game has a manager of its own, so any number of games can be run
+ * side by side as long as each is only used by one thread at a time.
+ */
+template <class Rules>
+class BasicGameManager {
 public:
-    static void beginGame(const string& player1Name, const string& player2Name);
+    typedef BasicGameBoard<Rules> Board;
+    typedef BasicTileBag<Rules> Bag;
+    typedef BasicPlayer<Rules> Player;
+    typedef BasicGameSnapshot<Rules> Snapshot;
+    typedef function<void(const string&, State)> Listener;
+
+    /**
+     * Construct a manager with no game in progress.
+     *
+     * @param chunkSize - the size of the chunks each game's arena grows by
+     */
+    explicit BasicGameManager(size_t chunkSize = Arena::DEFAULT_CHUNK_SIZE);
+
+    void beginGame(const string& player1Name, const string& player2Name);
+
+    void beginGame(const string& player1Name, const string& player2Name,
+        uint64_t seed);
+
+    void loadGame(const shared_ptr<Player>& player1,
+        const shared_ptr<Player>& player2, const shared_ptr<Bag>& loadedBag,
+        const shared_ptr<Board>& loadedBoard,
+        const shared_ptr<Player>& currentPlayer,
+        const shared_ptr<Arena>& loadedArena);
 
-    static void loadGame(const shared_ptr<Player>& player1,
-        const shared_ptr<Player>& player2, const shared_ptr<TileBag>& loadedBag,
-        const shared_ptr<GameBoard>& loadedBoard,
-        const shared_ptr<Player>& currentPlayer);
+    void placeTile(
+        Colour colour, Shape shape, size_t row, size_t column);
 
-    static void placeTile(Colour colour, Shape shape, size_t row, size_t column);
+    void replaceTile(Colour colour, Shape shape);
 
-    static void replaceTile(Colour colour, Shape shape);
+    void switchPlayer();
 
-    static void switchPlayer();
+    bool isGridLocationEmpty(size_t row, size_t column);
 
-    static bool isGridLocationEmpty(size_t row, size_t column);
+    bool isTileInHand(const Tile& tile);
 
-    static bool isTileInHand(const Tile& tile);
+    Lines getAdjacentLines(
+        const Tile& tile, size_t row, size_t column);
 
-    static Lines getAdjacentLines(const Tile& tile, size_t row, size_t column);
+    bool hasAdjacentTile(const Tile& tile, const Lines& lines);
 
-    static bool hasAdjacentTile(const Tile& tile, const Lines& lines);
+    bool isTileValidOnLine(const Tile& tile, const Lines& lines);
 
-    static bool isTileValidOnLine(const Tile& tile, const Lines& lines);
+    void updateScore(const Tile& tile, const Lines& lines);
 
-    static void updateScore(const Lines& lines);
+    bool hasGameEnded();
 
-    static bool hasGameEnded();
+    bool isStalemate();
 
-    static void resetGame();
+    void resetGame();
 
-    static shared_ptr<TileBag> bag;
-    static shared_ptr<Player> player1;
-    static shared_ptr<Player> player2;
-    static shared_ptr<Player> currentPlayer;
-    static shared_ptr<GameBoard> board;
+    shared_ptr<const Snapshot> snapshot();
+
+    void restore(const Snapshot& snapshot);
+
+    void copyOnWrite();
+
+    void notify(const string& message, State state);
+
+    const size_t chunkSize;
+    Listener listener;
+    weak_ptr<const Snapshot> lastSnapshot;
+    shared_ptr<Arena> arena;
+    shared_ptr<Bag> bag;
+    shared_ptr<Player> player1;
+    shared_ptr<Player> player2;
+    shared_ptr<Player> currentPlayer;
+    shared_ptr<Board> board;
 };
 
+typedef BasicGameManager<StandardRules> GameManager;
+
 #endif // !GAME_MANAGER_H
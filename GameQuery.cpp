@@ -0,0 +1,209 @@
+#include "GameQuery.h"
+
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+using std::endl;
+using std::exception_ptr;
+using std::setw;
+using std::thread;
+using std::vector;
+
+constexpr size_t ArchiveQuery::BLOCK_GAMES;
+
+// the heatmap shades a cell from none of the placements to the most any
+// cell had
+static const char SHADES[] = " .:-=+*#%@";
+
+/**
+ * Write the label of a statistic, leaving the stream ready for its value.
+ */
+static ostream& label(ostream& os, const string& name) {
+    return os << std::left << setw(24) << name << std::right << setw(12);
+}
+
+bool QueryFilter::matches(const ArchiveEntry& game) const {
+    string firstName = game.getName(0);
+    string secondName = game.getName(1);
+    size_t moves = game.getMoveCount();
+    return (player.empty() || player == firstName || player == secondName) &&
+        (first.empty() || first == firstName) &&
+        (second.empty() || second == secondName) &&
+        moves >= minMoves && (maxMoves == 0 || moves <= maxMoves) &&
+        std::max(game.getScore(0), game.getScore(1)) >= minScore;
+}
+
+QueryTotals& QueryTotals::operator+=(const QueryTotals& other) {
+    games += other.games;
+    mismatched += other.mismatched;
+    placements += other.placements;
+    replacements += other.replacements;
+    passes += other.passes;
+    points += other.points;
+    qwirkles += other.qwirkles;
+    firstWins += other.firstWins;
+    secondWins += other.secondWins;
+    draws += other.draws;
+    firstMargin += other.firstMargin;
+    for (size_t cell = 0; cell < heatmap.size(); ++cell)
+        heatmap[cell] += other.heatmap[cell];
+
+    return *this;
+}
+
+void QueryTotals::print(ostream& os, bool heatmap) const {
+    double games = std::max<uint64_t>(this->games, 1);
+    double turns = std::max<uint64_t>(placements + replacements + passes, 1);
+
+    os << std::fixed << std::setprecision(2);
+    label(os, "Games") << this->games << endl;
+    if (mismatched > 0)
+        label(os, "Mismatched") << mismatched << endl;
+    label(os, "Turns per game") << turns / games << endl;
+    label(os, "Points per turn") << points / turns << endl;
+    label(os, "Points per placement")
+        << points / std::max<double>(placements, 1) << endl;
+    label(os, "Qwirkles per game") << qwirkles / games << endl;
+    label(os, "Replace %") << 100 * replacements / turns << endl;
+    label(os, "Pass %") << 100 * passes / turns << endl;
+    label(os, "First player win %")
+        << 100 * (firstWins + 0.5 * draws) / games << endl;
+    label(os, "First player margin") << std::showpos
+        << firstMargin / games << std::noshowpos << endl;
+    os << "First player won " << firstWins << ", drew " << draws
+       << " and lost " << secondWins << endl;
+
+    if (!heatmap)
+        return;
+
+    uint64_t most = *std::max_element(this->heatmap.begin(),
+        this->heatmap.end());
+    size_t shades = sizeof(SHADES) - 2;
+    os << endl << "  ";
+    for (size_t column = 0; column < StandardRules::BOARD_LENGTH; ++column)
+        os << ' ' << column % 10;
+    os << endl;
+    for (size_t row = 0; row < StandardRules::BOARD_LENGTH; ++row) {
+        os << char('A' + row) << " ";
+        for (size_t column = 0; column < StandardRules::BOARD_LENGTH;
+             ++column) {
+            uint64_t placed =
+                this->heatmap[row * StandardRules::BOARD_LENGTH + column];
+            // any placement at all shows, however few
+            size_t shade = most == 0 ? 0
+                : (placed * shades + most - 1) / most;
+            os << ' ' << SHADES[shade];
+        }
+        os << endl;
+    }
+}
+
+ArchiveQuery::ArchiveQuery(const ArchiveReader& reader,
+    const QueryFilter& filter)
+    : reader(reader), filter(filter), next(0) {}
+
+QueryTotals ArchiveQuery::run(size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, thread::hardware_concurrency());
+
+    // a failure on any thread is thrown once every thread has stopped
+    next = 0;
+    vector<QueryTotals> totals(threads);
+    vector<exception_ptr> failures(threads);
+    auto scan = [this, &totals, &failures](size_t worker) {
+        try {
+            work(totals[worker]);
+        } catch (...) {
+            failures[worker] = std::current_exception();
+            next = reader.getGameCount();
+        }
+    };
+
+    vector<thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(scan, i);
+    scan(0);
+    for (thread& worker : workers)
+        worker.join();
+
+    for (const exception_ptr& failure : failures) {
+        if (failure)
+            std::rethrow_exception(failure);
+    }
+    for (size_t i = 1; i < threads; ++i)
+        totals[0] += totals[i];
+
+    return totals[0];
+}
+
+void ArchiveQuery::work(QueryTotals& totals) {
+    GameManager manager;
+    uint64_t qwirkles = 0;
+    manager.listener = [&qwirkles](const string& message, State state) {
+        if (state == QWIRKLE)
+            ++qwirkles;
+    };
+
+    size_t games = reader.getGameCount();
+    for (size_t start = next.fetch_add(BLOCK_GAMES); start < games;
+         start = next.fetch_add(BLOCK_GAMES)) {
+        for (size_t i = start; i < std::min(start + BLOCK_GAMES, games);
+             ++i) {
+            ArchiveEntry game = reader.getGame(i);
+            qwirkles = 0;
+            if (filter.matches(game) && count(game, manager, totals))
+                totals.qwirkles += qwirkles;
+        }
+    }
+}
+
+bool ArchiveQuery::count(const ArchiveEntry& game, GameManager& manager,
+    QueryTotals& totals) const {
+    game.deal(manager);
+
+    // a move may copy the player, so look them up again by seat
+    uint64_t points = 0;
+    for (size_t i = 0; i < game.getMoveCount(); ++i) {
+        ArchivedMove move = game.getMove(i);
+        bool firstMoving = manager.currentPlayer == manager.player1;
+        size_t score = manager.currentPlayer->getScore();
+        ArchiveEntry::play(manager, move);
+        if (move.action == ArchivedMove::PLACE) {
+            points += (firstMoving ? manager.player1 : manager.player2)
+                ->getScore() - score;
+        }
+    }
+
+    size_t first = manager.player1->getScore();
+    size_t second = manager.player2->getScore();
+    manager.resetGame();
+    if (first != game.getScore(0) || second != game.getScore(1)) {
+        ++totals.mismatched;
+        return false;
+    }
+
+    // the moves are read again only once the game is known to be good
+    for (size_t i = 0; i < game.getMoveCount(); ++i) {
+        ArchivedMove move = game.getMove(i);
+        if (move.action == ArchivedMove::PLACE) {
+            ++totals.placements;
+            ++totals.heatmap[
+                move.row * StandardRules::BOARD_LENGTH + move.column];
+        } else if (move.action == ArchivedMove::REPLACE) {
+            ++totals.replacements;
+        } else {
+            ++totals.passes;
+        }
+    }
+
+    ++totals.games;
+    totals.points += points;
+    totals.firstWins += first > second;
+    totals.secondWins += second > first;
+    totals.draws += first == second;
+    totals.firstMargin += int64_t(first) - int64_t(second);
+    return true;
+}
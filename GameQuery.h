@@ -0,0 +1,133 @@
+#ifndef GAME_QUERY_H
+#define GAME_QUERY_H
+
+#include "GameArchive.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using std::array;
+using std::atomic;
+using std::ostream;
+using std::string;
+
+/**
+ * Which games of an archive a query looks at. Every condition given must
+ * hold, and an empty name or a zero bound is no condition.
+ */
+struct QueryFilter {
+    // a player in either seat, in the first seat or in the second
+    string player;
+    string first;
+    string second;
+
+    // bounds on the number of moves and on the winner's final score
+    size_t minMoves = 0;
+    size_t maxMoves = 0;
+    size_t minScore = 0;
+
+    /**
+     * Check a game against the filter, from its fixed fields alone.
+     */
+    bool matches(const ArchiveEntry& game) const;
+};
+
+/**
+ * What a query has counted over the games it looked at. Each thread of a
+ * query counts into its own totals, added together once every game is done.
+ */
+struct QueryTotals {
+    uint64_t games = 0;
+
+    // the games whose replayed scores differ from the archived ones, not
+    // counted in anything else
+    uint64_t mismatched = 0;
+
+    uint64_t placements = 0;
+    uint64_t replacements = 0;
+    uint64_t passes = 0;
+    uint64_t points = 0;
+    uint64_t qwirkles = 0;
+
+    // the outcomes from the first player's side, and the points they ended
+    // up ahead by over every game
+    uint64_t firstWins = 0;
+    uint64_t secondWins = 0;
+    uint64_t draws = 0;
+    int64_t firstMargin = 0;
+
+    // the placements made in each cell
+    array<uint64_t, StandardRules::CELLS> heatmap{};
+
+    /**
+     * Add another set of totals to these.
+     */
+    QueryTotals& operator+=(const QueryTotals& other);
+
+    /**
+     * Write the statistics the totals give, and the heatmap as a grid of
+     * the share of placements in each cell.
+     *
+     * @param os - the stream to write to
+     * @param heatmap - whether to write the heatmap
+     */
+    void print(ostream& os, bool heatmap) const;
+};
+
+/**
+ * @note
+ * Scans an archive on every core at once. Threads claim runs of games from
+ * a shared counter and read them in place from the mapped file, skipping a
+ * game the filter rejects without decoding a move of it. Every game kept is
+ * dealt into the thread's own manager and replayed, so the points of each
+ * move and every qwirkle are found by the game's own scoring, and counted
+ * into the thread's own totals without any locking.
+ */
+class ArchiveQuery {
+public:
+    // the games a thread claims at a time
+    static constexpr size_t BLOCK_GAMES = 256;
+
+    /**
+     * Construct a query over an archive.
+     *
+     * @param reader - the archive, which must outlive the query
+     * @param filter - the games to look at
+     */
+    ArchiveQuery(const ArchiveReader& reader, const QueryFilter& filter);
+
+    /**
+     * Scan every game.
+     *
+     * @param threads - the number of threads, 0 for one per core
+     * @return the totals over the games the filter keeps
+     * @throws runtime_error if a game of the archive is not valid
+     */
+    QueryTotals run(size_t threads);
+
+private:
+    /**
+     * Scan games until none are left.
+     *
+     * @param totals - the totals to count into
+     */
+    void work(QueryTotals& totals);
+
+    /**
+     * Replay a game and count it.
+     *
+     * @return false if the game does not replay as archived, when it is
+     * only counted as mismatched
+     */
+    bool count(const ArchiveEntry& game, GameManager& manager,
+        QueryTotals& totals) const;
+
+    const ArchiveReader& reader;
+    const QueryFilter filter;
+    atomic<size_t> next;
+};
+
+#endif // !GAME_QUERY_H
@@ -0,0 +1,514 @@
+#include "GameServer.h"
+#include "Constants.h"
+#include "Notation.h"
+#include "Stats.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::endl;
+using std::lock_guard;
+using std::make_unique;
+using std::ostringstream;
+using std::runtime_error;
+
+constexpr size_t GameServer::GAME_CHUNK_SIZE;
+constexpr size_t GameServer::MAX_COMMAND_LENGTH;
+constexpr size_t GameServer::MAX_PENDING_INPUT;
+constexpr size_t GameServer::MAX_PENDING_OUTPUT;
+
+// the number of events taken from the epoll set at a time
+static const int EVENT_BATCH = 64;
+
+// the size of the buffer a socket is read through
+static const size_t READ_SIZE = 4096;
+
+// the prompt written after every reply
+static const char* const PROMPT = "> ";
+
+/**
+ * Throw the error of a failed system call.
+ *
+ * @param call - the name of the call
+ */
+static void fail(const string& call) {
+    throw runtime_error(call + ": " + strerror(errno));
+}
+
+int GameServer::listenUnix(const string& path) {
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path))
+        throw runtime_error("socket path too long: " + path);
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    int socket = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+        0);
+    if (socket < 0)
+        fail("socket");
+
+    unlink(path.c_str());
+    if (bind(socket, reinterpret_cast<sockaddr*>(&address),
+            sizeof(address)) < 0 || listen(socket, SOMAXCONN) < 0) {
+        ::close(socket);
+        fail("bind " + path);
+    }
+
+    return socket;
+}
+
+int GameServer::listenLoopback(uint16_t port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int socket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+        0);
+    if (socket < 0)
+        fail("socket");
+
+    int enabled = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+    if (bind(socket, reinterpret_cast<sockaddr*>(&address),
+            sizeof(address)) < 0 || listen(socket, SOMAXCONN) < 0) {
+        ::close(socket);
+        fail("bind port " + std::to_string(port));
+    }
+
+    return socket;
+}
+
+GameServer::GameServer(int listener, size_t loops,
+    const string& saveDirectory)
+    : listener(listener), connections(0), stopping(false),
+      saver(make_unique<AutoSaver>()) {
+    if (mkdir(saveDirectory.c_str(), 0755) < 0 && errno != EEXIST)
+        fail("mkdir " + saveDirectory);
+
+    // the start time keeps a later run from reusing the same names
+    savePrefix = saveDirectory + "/" + std::to_string(std::time(nullptr)) +
+        "-";
+
+    if (loops == 0)
+        loops = std::max(1u, thread::hardware_concurrency());
+
+    // with several loops the kernel wakes only one of them per connection
+    uint32_t acceptEvents = loops > 1 ? EPOLLIN | EPOLLEXCLUSIVE : EPOLLIN;
+    for (size_t i = 0; i < loops; ++i) {
+        unique_ptr<Loop> loop = make_unique<Loop>();
+        loop->epoll = epoll_create1(EPOLL_CLOEXEC);
+        loop->wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        this->loops.push_back(std::move(loop));
+
+        Loop& added = *this->loops.back();
+        if (added.epoll < 0 || added.wakeup < 0)
+            fail("epoll");
+
+        epoll_event event{};
+        event.events = acceptEvents;
+        event.data.fd = listener;
+        if (epoll_ctl(added.epoll, EPOLL_CTL_ADD, listener, &event) < 0)
+            fail("epoll_ctl");
+
+        event.events = EPOLLIN;
+        event.data.fd = added.wakeup;
+        if (epoll_ctl(added.epoll, EPOLL_CTL_ADD, added.wakeup, &event) < 0)
+            fail("epoll_ctl");
+    }
+}
+
+GameServer::~GameServer() {
+    stop();
+
+    // the writer finishes the saves queued, still waking the loops
+    saver.reset();
+    for (unique_ptr<Loop>& loop : loops) {
+        if (loop->epoll >= 0)
+            ::close(loop->epoll);
+        if (loop->wakeup >= 0)
+            ::close(loop->wakeup);
+    }
+    ::close(listener);
+}
+
+void GameServer::start() {
+    stopping = false;
+    for (unique_ptr<Loop>& loop : loops) {
+        Loop& started = *loop;
+        started.worker = thread([this, &started] { run(started); });
+    }
+}
+
+void GameServer::stop() {
+    uint64_t signal = 1;
+    stopping = true;
+    for (unique_ptr<Loop>& loop : loops) {
+        if (loop->worker.joinable() &&
+            write(loop->wakeup, &signal, sizeof(signal)) < 0)
+            loop->worker.detach();
+    }
+
+    for (unique_ptr<Loop>& loop : loops) {
+        if (loop->worker.joinable())
+            loop->worker.join();
+    }
+}
+
+void GameServer::run(Loop& loop) {
+    epoll_event events[EVENT_BATCH];
+    bool running = true;
+
+    while (running) {
+        int count = epoll_wait(loop.epoll, events, EVENT_BATCH, -1);
+        for (int i = 0; i < count; ++i) {
+            int socket = events[i].data.fd;
+            if (socket == listener) {
+                accept(loop);
+            } else if (socket == loop.wakeup) {
+                // woken to stop, or for saves the writer has finished
+                uint64_t signals;
+                if (read(loop.wakeup, &signals, sizeof(signals)) > 0)
+                    finishSaves(loop);
+                running = !stopping;
+            } else {
+                // a session closed earlier in the batch has no entry
+                auto found = loop.sessions.find(socket);
+                if (found == loop.sessions.end())
+                    continue;
+
+                Session& session = *found->second;
+                bool open = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0;
+                if (open && (events[i].events & EPOLLIN))
+                    open = receive(loop, session);
+                if (open)
+                    open = flush(loop, session);
+                if (!open)
+                    close(loop, socket);
+            }
+        }
+    }
+
+    for (auto& entry : loop.sessions)
+        ::close(entry.first);
+    loop.sessions.clear();
+}
+
+void GameServer::accept(Loop& loop) {
+    int socket;
+    while ((socket = accept4(listener, nullptr, nullptr,
+                SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0) {
+        unique_ptr<Session> session = make_unique<Session>();
+        session->id = ++connections;
+        session->socket = socket;
+        session->events = EPOLLIN | EPOLLRDHUP;
+        session->closing = false;
+        session->ended = false;
+        session->saving = false;
+
+        epoll_event event{};
+        event.events = session->events;
+        event.data.fd = socket;
+        if (epoll_ctl(loop.epoll, EPOLL_CTL_ADD, socket, &event) < 0) {
+            ::close(socket);
+            continue;
+        }
+
+        session->output = "Welcome to Qwirkle!\n";
+        session->output += PROMPT;
+        Session& added = *session;
+        loop.sessions[socket] = std::move(session);
+        if (!flush(loop, added))
+            close(loop, socket);
+    }
+}
+
+bool GameServer::receive(Loop& loop, Session& session) {
+    char buffer[READ_SIZE];
+    bool open = true;
+
+    // the rest is read once the commands held back have run
+    while (open && !session.ended &&
+           session.input.size() < MAX_PENDING_INPUT) {
+        ssize_t count = read(session.socket, buffer, std::min(sizeof(buffer),
+            MAX_PENDING_INPUT - session.input.size()));
+        if (count > 0)
+            session.input.append(buffer, count);
+        else if (count == 0)
+            session.ended = true;
+        else
+            open = false;
+    }
+    open = open || errno == EAGAIN || errno == EWOULDBLOCK;
+
+    process(loop, session);
+
+    // commands held back behind a save are complete, only the unfinished
+    // one after them is limited
+    size_t last = session.input.rfind('\n');
+    size_t unfinished = last == string::npos
+        ? session.input.size() : session.input.size() - last - 1;
+
+    return open && unfinished <= MAX_COMMAND_LENGTH &&
+        session.output.size() <= MAX_PENDING_OUTPUT;
+}
+
+void GameServer::process(Loop& loop, Session& session) {
+    size_t start = 0;
+    size_t end;
+    while (!session.closing && !session.saving &&
+           (end = session.input.find('\n', start)) != string::npos) {
+        execute(loop, session, session.input.substr(start, end - start));
+        start = end + 1;
+    }
+    session.input.erase(0, session.closing ? string::npos : start);
+
+    // a client that has finished sending still gets its replies
+    session.closing = session.closing || (session.ended && !session.saving);
+}
+
+void GameServer::finishSaves(Loop& loop) {
+    vector<Saved> saved;
+    {
+        lock_guard<mutex> guard(loop.lock);
+        saved.swap(loop.saved);
+    }
+
+    for (const Saved& save : saved) {
+        // the client may have gone, and its socket been reused since
+        auto found = loop.sessions.find(save.socket);
+        if (found == loop.sessions.end() || found->second->id != save.id)
+            continue;
+
+        Session& session = *found->second;
+        session.output += save.written
+            ? "Game successfully saved\n" : "Game could not be saved\n";
+        session.output += PROMPT;
+        session.saving = false;
+        process(loop, session);
+        if (session.output.size() > MAX_PENDING_OUTPUT ||
+            !flush(loop, session))
+            close(loop, save.socket);
+    }
+}
+
+bool GameServer::flush(Loop& loop, Session& session) {
+    bool open = true;
+    size_t written = 0;
+    while (open && written < session.output.size()) {
+        ssize_t count = send(session.socket, session.output.data() + written,
+            session.output.size() - written, MSG_NOSIGNAL);
+        if (count > 0)
+            written += count;
+        else if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            open = false;
+    }
+    session.output.erase(0, written);
+
+    // only wait for the socket to become writable while output is left, and
+    // stop reading from a session that is closing or waiting for a save
+    uint32_t events = session.closing || session.saving
+        ? 0 : EPOLLIN | EPOLLRDHUP;
+    if (!session.output.empty())
+        events |= EPOLLOUT;
+    if (open && events != session.events) {
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = session.socket;
+        open = epoll_ctl(loop.epoll, EPOLL_CTL_MOD, session.socket, &event)
+            == 0;
+        session.events = events;
+    }
+
+    return open && !(session.closing && session.output.empty());
+}
+
+void GameServer::close(Loop& loop, int socket) {
+    epoll_ctl(loop.epoll, EPOLL_CTL_DEL, socket, nullptr);
+    ::close(socket);
+    loop.sessions.erase(socket);
+}
+
+void GameServer::execute(Loop& loop, Session& session, const string& line) {
+    if (session.bot) {
+        session.output += session.bot->handle(line) + "\n";
+        session.closing = session.bot->isFinished();
+        return;
+    }
+
+    STATS_TIME(TIMER_PARSE);
+    string operation, tile, keywordAT, pos;
+    std::istringstream command(line);
+    command >> operation >> tile >> keywordAT >> pos;
+
+    string name = tile;
+    transform(operation.begin(), operation.end(), operation.begin(),
+        ::tolower);
+    transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
+    transform(keywordAT.begin(), keywordAT.end(), keywordAT.begin(),
+        ::tolower);
+    transform(pos.begin(), pos.end(), pos.begin(), ::toupper);
+    STATS_STOP();
+
+    GameManager* game = session.game.get();
+    bool playing = game != nullptr && game->board != nullptr;
+    Colour colour;
+    Shape shape;
+    size_t row;
+    size_t column;
+
+    if (operation == "new") {
+        // the names are taken as typed, the keyword was lower cased
+        string player1Name, player2Name;
+        std::istringstream names(line);
+        names >> operation >> player1Name >> player2Name;
+        newGame(session, player1Name, player2Name);
+    } else if (operation == "bot" && tile.empty()) {
+        // the rest of the session speaks the bot protocol, with no prompts
+        session.bot = make_unique<BotProtocol>();
+        session.output += "ok\n";
+        return;
+    } else if (operation == "quit") {
+        session.output += "Goodbye\n";
+        session.closing = true;
+        return;
+    } else if (operation.empty()) {
+        // a blank line only asks for another prompt
+    } else if (!playing && (operation == "place" || operation == "replace" ||
+                            operation == "save" || operation == "show")) {
+        session.output += ERROR_MESSAGE "No game in progress.\n";
+    } else if (operation == "place" && keywordAT == "at") {
+        if (!parseTile(tile, colour, shape))
+            session.output += ERROR_MESSAGE "Not a valid tile.\n";
+        else if (!parsePosition(pos, row, column))
+            session.output += ERROR_MESSAGE "Not a valid position.\n";
+        else
+            game->placeTile(colour, shape, row, column);
+    } else if (operation == "replace" && keywordAT.empty() && pos.empty()) {
+        if (parseTile(tile, colour, shape))
+            game->replaceTile(colour, shape);
+        else
+            session.output += ERROR_MESSAGE "Not a valid tile.\n";
+    } else if (operation == "save" && !name.empty() &&
+               std::all_of(name.begin(), name.end(), ::isalnum)) {
+        // the prompt follows the reply once the save is written
+        save(loop, session, name);
+        return;
+    } else if (operation == "show" && tile.empty()) {
+        showRound(session);
+    } else {
+        session.output += ERROR_MESSAGE "Not a valid command.\n";
+    }
+
+    session.output += PROMPT;
+}
+
+void GameServer::save(Loop& loop, Session& session, const string& name) {
+    STATS_TIME(TIMER_SAVE);
+    session.saving = true;
+    Loop* owner = &loop;
+    Saved saved = {session.socket, session.id, false};
+    saver->saveAs(
+        savePrefix + std::to_string(session.id) + "-" + name + ".save",
+        session.game->snapshot(), [owner, saved](bool written) mutable {
+            saved.written = written;
+            {
+                lock_guard<mutex> guard(owner->lock);
+                owner->saved.push_back(saved);
+            }
+
+            uint64_t signal = 1;
+            if (write(owner->wakeup, &signal, sizeof(signal)) < 0)
+                cerr << "Could not wake a loop for a save." << endl;
+        });
+}
+
+void GameServer::newGame(Session& session, const string& player1Name,
+    const string& player2Name) {
+    bool valid = !player1Name.empty() && !player2Name.empty() &&
+        player1Name != player2Name &&
+        std::all_of(player1Name.begin(), player1Name.end(), ::isupper) &&
+        std::all_of(player2Name.begin(), player2Name.end(), ::isupper);
+    if (!valid) {
+        session.output += ERROR_MESSAGE "Must enter two different names in "
+            "CAPS for the players.\n";
+        return;
+    }
+
+    if (!session.game) {
+        session.game = make_unique<GameManager>(GAME_CHUNK_SIZE);
+        Session* owner = &session;
+        session.game->listener = [this, owner](const string& message,
+            State state) { notify(*owner, message, state); };
+    }
+
+    session.game->beginGame(player1Name, player2Name);
+    session.output += "Let's Play!\n";
+    showRound(session);
+}
+
+void GameServer::showRound(Session& session) {
+    STATS_TIME(TIMER_RENDER);
+    const GameManager& game = *session.game;
+    ostringstream round;
+    round << endl;
+    round << game.currentPlayer->getName() << ", it's your turn " << endl;
+    round << "Score for " << game.player1->getName() << ": "
+          << game.player1->getScore() << endl;
+    round << "Score for " << game.player2->getName() << ": "
+          << game.player2->getScore() << endl;
+    round << endl;
+    round << *game.board << endl;
+    round << "Your hand is " << endl;
+    round << *game.currentPlayer->getHand() << endl;
+    session.output += round.str();
+}
+
+void GameServer::notify(Session& session, const string& message,
+    State state) {
+    GameManager& game = *session.game;
+    ostringstream reply;
+
+    if (state == PLACE_FAILURE || state == REPLACE_FAILURE) {
+        reply << ERROR_MESSAGE << message << endl;
+    } else if (state == GAME_OVER) {
+        reply << endl;
+        reply << *game.board << endl;
+        reply << "Game Over" << endl;
+        reply << "Score for " << game.player1->getName() << " : "
+              << game.player1->getScore() << endl;
+        reply << "Score for " << game.player2->getName() << " : "
+              << game.player2->getScore() << endl;
+        const shared_ptr<Player>& winner =
+            game.player1->getScore() > game.player2->getScore()
+            ? game.player1 : game.player2;
+        reply << "Player " << winner->getName() << " won!" << endl;
+        game.resetGame();
+    } else {
+        reply << message << endl;
+        if (state != QWIRKLE)
+            reply << game.currentPlayer->getName() << ", it's your turn"
+                  << endl;
+    }
+
+    session.output += reply.str();
+}
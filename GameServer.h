@@ -0,0 +1,244 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include "AutoSaver.h"
+#include "BotProtocol.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using std::atomic;
+using std::mutex;
+using std::string;
+using std::thread;
+using std::unique_ptr;
+using std::unordered_map;
+using std::vector;
+
+/**
+ * @note
+ * Hosts games for clients connected over a socket, speaking the command
+ * language of the console game a line at a time, or the bot protocol once a
+ * client asks for it with "bot". Each connection plays a game of its own and
+ * is served by one of a few event loops, each a thread waiting on an epoll
+ * set of its connections, so an idle connection costs only its buffers and
+ * its game. Every loop waits on the listening socket as
+ * well and the kernel wakes one of them for each new connection, which then
+ * stays on that loop, so no game is ever touched by two threads.
+ *
+ * Saves are written by an autosaver's writer thread into the directory the
+ * server is given, each connection naming files under a prefix of its own so
+ * that clients never replace each other's saves. A session's later commands
+ * wait until the writer reports back through its loop's wakeup.
+ */
+class GameServer {
+public:
+    // the size of the chunks each game's arena grows by, enough for a game
+    static constexpr size_t GAME_CHUNK_SIZE = 32 * 1024;
+
+    // the longest command accepted, a client sending more is disconnected
+    static constexpr size_t MAX_COMMAND_LENGTH = 256;
+
+    // the most input held for a client, reading stops until it is run
+    static constexpr size_t MAX_PENDING_INPUT = 64 * 1024;
+
+    // the most output held for a client that is not reading it
+    static constexpr size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+
+    /**
+     * Open a listening Unix-domain socket, replacing any stale socket file.
+     *
+     * @param path - the path of the socket
+     * @return the listening socket
+     * @throws runtime_error if the socket cannot be opened
+     */
+    static int listenUnix(const string& path);
+
+    /**
+     * Open a listening TCP socket on the loopback interface.
+     *
+     * @param port - the port
+     * @return the listening socket
+     * @throws runtime_error if the socket cannot be opened
+     */
+    static int listenLoopback(uint16_t port);
+
+    /**
+     * Construct a server accepting connections on a listening socket, which
+     * the server takes ownership of.
+     *
+     * @param listener - the listening socket
+     * @param loops - the number of event loops, 0 for one per core
+     * @param saveDirectory - the directory games are saved in, created if
+     * it does not exist
+     * @throws runtime_error if an event loop or the directory cannot be
+     * created
+     */
+    GameServer(int listener, size_t loops, const string& saveDirectory);
+
+    /**
+     * Destructor to stop the event loops and close every connection.
+     */
+    ~GameServer();
+
+    /**
+     * Start the event loops, each on a thread of its own.
+     */
+    void start();
+
+    /**
+     * Stop the event loops and wait for them to finish. Connections are
+     * closed and their games discarded.
+     */
+    void stop();
+
+private:
+    /**
+     * A connected client with the game it is playing.
+     */
+    struct Session {
+        // unique to the connection, so a reused socket is not mistaken for it
+        uint64_t id;
+        int socket;
+        string input;
+        string output;
+        unique_ptr<GameManager> game;
+
+        // the protocol the session speaks once it asks for the bot protocol
+        unique_ptr<BotProtocol> bot;
+
+        // the events the loop waits for on the socket
+        uint32_t events;
+
+        // whether the session is closed once its output is written
+        bool closing;
+
+        // whether the client has finished sending
+        bool ended;
+
+        // whether a save is being written, holding back later commands
+        bool saving;
+    };
+
+    /**
+     * A save the writer has finished, for the session that asked for it.
+     */
+    struct Saved {
+        int socket;
+        uint64_t id;
+        bool written;
+    };
+
+    /**
+     * An event loop with the connections it serves.
+     */
+    struct Loop {
+        int epoll;
+        int wakeup;
+        unordered_map<int, unique_ptr<Session>> sessions;
+        thread worker;
+
+        // the saves finished by the writer, guarded by the lock
+        mutex lock;
+        vector<Saved> saved;
+    };
+
+    /**
+     * Run an event loop until the server is stopped.
+     */
+    void run(Loop& loop);
+
+    /**
+     * Accept every pending connection on to the loop.
+     */
+    void accept(Loop& loop);
+
+    /**
+     * Read what a client has sent and run each complete command.
+     *
+     * @return false if the session has to be closed
+     */
+    bool receive(Loop& loop, Session& session);
+
+    /**
+     * Run each complete command a session has sent, until one has to wait
+     * for a save.
+     */
+    void process(Loop& loop, Session& session);
+
+    /**
+     * Reply to the sessions whose saves the writer has finished and run
+     * the commands they sent meanwhile.
+     */
+    void finishSaves(Loop& loop);
+
+    /**
+     * Write as much of a session's output as the socket takes, waiting for
+     * the socket to become writable if some is left.
+     *
+     * @return false if the session has to be closed
+     */
+    bool flush(Loop& loop, Session& session);
+
+    /**
+     * Close a session's socket and discard its game.
+     */
+    void close(Loop& loop, int socket);
+
+    /**
+     * Run a command, writing the reply to the session's output.
+     *
+     * @param line - the command
+     */
+    void execute(Loop& loop, Session& session, const string& line);
+
+    /**
+     * Queue a session's game to be saved by the writer, replying once it
+     * has been.
+     *
+     * @param name - the name the client gave the save
+     */
+    void save(Loop& loop, Session& session, const string& name);
+
+    /**
+     * Start a new game for a session.
+     *
+     * @param player1Name,player2Name - the names of the players
+     */
+    void newGame(Session& session, const string& player1Name,
+        const string& player2Name);
+
+    /**
+     * Write the scores, board and hand of the player to move.
+     */
+    void showRound(Session& session);
+
+    /**
+     * Write the outcome of a move, and the final scores once the game is
+     * over, to the session's output.
+     */
+    void notify(Session& session, const string& message, State state);
+
+    const int listener;
+    vector<unique_ptr<Loop>> loops;
+
+    // the path every save file name starts with, unique to the server run
+    string savePrefix;
+
+    // the number of connections accepted, giving each session its id
+    atomic<uint64_t> connections;
+
+    // whether a loop woken up is to stop
+    atomic<bool> stopping;
+
+    // released once the loops have stopped, before they are
+    unique_ptr<AutoSaver> saver;
+};
+
+#endif // !GAME_SERVER_H
@@ -0,0 +1,67 @@
+#include "GameSnapshot.h"
+
+using std::endl;
+
+template <class Rules>
+BasicGameSnapshot<Rules>::BasicGameSnapshot(
+    const shared_ptr<const Board>& board,
+    const shared_ptr<const Bag>& bag,
+    const shared_ptr<const Player>& player1,
+    const shared_ptr<const Player>& player2,
+    const shared_ptr<const Player>& currentPlayer)
+    : board(board), bag(bag), player1(player1), player2(player2),
+      currentPlayer(currentPlayer) {}
+
+template <class Rules>
+shared_ptr<const BasicGameBoard<Rules>>
+BasicGameSnapshot<Rules>::getBoard() const {
+    return board;
+}
+
+template <class Rules>
+shared_ptr<const BasicTileBag<Rules>> BasicGameSnapshot<Rules>::getBag() const {
+    return bag;
+}
+
+template <class Rules>
+shared_ptr<const BasicPlayer<Rules>>
+BasicGameSnapshot<Rules>::getPlayer1() const {
+    return player1;
+}
+
+template <class Rules>
+shared_ptr<const BasicPlayer<Rules>>
+BasicGameSnapshot<Rules>::getPlayer2() const {
+    return player2;
+}
+
+template <class Rules>
+shared_ptr<const BasicPlayer<Rules>>
+BasicGameSnapshot<Rules>::getCurrentPlayer() const {
+    return currentPlayer;
+}
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicGameSnapshot<Rules>& snapshot) {
+    os << snapshot.player1->getName() << endl;
+    os << snapshot.player1->getScore() << endl;
+    os << *snapshot.player1->getHand()->getTiles() << endl;
+    os << snapshot.player2->getName() << endl;
+    os << snapshot.player2->getScore() << endl;
+    os << *snapshot.player2->getHand()->getTiles() << endl;
+    os << Rules::BOARD_LENGTH << "," << Rules::BOARD_LENGTH << endl;
+    snapshot.board->save(os);
+    os << endl;
+    os << *snapshot.bag->getTiles() << endl;
+    os << snapshot.currentPlayer->getName() << endl;
+
+    return os;
+}
+
+template class BasicGameSnapshot<StandardRules>;
+template ostream& operator<<(
+    ostream&, const BasicGameSnapshot<StandardRules>&);
+
+template class BasicGameSnapshot<ExtendedRules>;
+template ostream& operator<<(
+    ostream&, const BasicGameSnapshot<ExtendedRules>&);
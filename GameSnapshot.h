@@ -0,0 +1,91 @@
+#ifndef GAME_SNAPSHOT_H
+#define GAME_SNAPSHOT_H
+
+#include "GameBoard.h"
+#include "Player.h"
+
+template <class Rules>
+class BasicGameSnapshot;
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicGameSnapshot<Rules>& snapshot);
+
+/**
+ * @note
+ * An immutable view of a game at a point in time. The snapshot shares the
+ * board, bag and players with the live game until the game is next mutated,
+ * at which point GameManager copies its state before writing to it, so a
+ * snapshot may be read from any thread while the game carries on.
+ */
+template <class Rules>
+class BasicGameSnapshot {
+public:
+    typedef BasicGameBoard<Rules> Board;
+    typedef BasicTileBag<Rules> Bag;
+    typedef BasicPlayer<Rules> Player;
+
+    /**
+     * Construct a snapshot sharing the given game state.
+     */
+    BasicGameSnapshot(const shared_ptr<const Board>& board,
+        const shared_ptr<const Bag>& bag,
+        const shared_ptr<const Player>& player1,
+        const shared_ptr<const Player>& player2,
+        const shared_ptr<const Player>& currentPlayer);
+
+    /**
+     * Get the board at the time of the snapshot.
+     *
+     * @return a pointer to the const GameBoard
+     */
+    shared_ptr<const Board> getBoard() const;
+
+    /**
+     * Get the bag at the time of the snapshot.
+     *
+     * @return a pointer to the const TileBag
+     */
+    shared_ptr<const Bag> getBag() const;
+
+    /**
+     * Get the first player, including their hand and score.
+     *
+     * @return a pointer to the const Player
+     */
+    shared_ptr<const Player> getPlayer1() const;
+
+    /**
+     * Get the second player, including their hand and score.
+     *
+     * @return a pointer to the const Player
+     */
+    shared_ptr<const Player> getPlayer2() const;
+
+    /**
+     * Get the player whose turn it was at the time of the snapshot.
+     *
+     * @return a pointer to the const Player
+     */
+    shared_ptr<const Player> getCurrentPlayer() const;
+
+    /**
+     * Overloaded output stream operator for writing the snapshot in the .save
+     * file format.
+     *
+     * @param os - a reference to the output stream
+     * @param snapshot - a reference to the snapshot to be saved
+     */
+    friend ostream& operator<< <>(
+        ostream& os, const BasicGameSnapshot& snapshot);
+
+private:
+    const shared_ptr<const Board> board;
+    const shared_ptr<const Bag> bag;
+    const shared_ptr<const Player> player1;
+    const shared_ptr<const Player> player2;
+    const shared_ptr<const Player> currentPlayer;
+};
+
+typedef BasicGameSnapshot<StandardRules> GameSnapshot;
+
+#endif // !GAME_SNAPSHOT_H
@@ -1,9 +1,15 @@
 #include "IOHandler.h"
 #include "TileCodes.h"
 #include "Constants.h"
+#include "EndgameSolver.h"
+#include "MoveSearch.h"
+#include "Notation.h"
+#include "Stats.h"
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <limits>
 #include <sstream>
@@ -16,8 +22,17 @@ using std::endl;
 
 bool IOHandler::gameRunning = false;
 bool IOHandler::takingInput = false;
+bool IOHandler::ansi = false;
+bool IOHandler::boardShown = false;
+bool IOHandler::crop = false;
+shared_ptr<AutoSaver> IOHandler::autoSaver = nullptr;
+string IOHandler::lastMove;
+shared_ptr<GameManager> IOHandler::game = nullptr;
 
 void IOHandler::beginGame() {
+    game = make_shared<GameManager>();
+    game->listener = IOHandler::notify;
+
     cout << "Welcome to Qwirkle!" << endl;
     cout << "-------------------" << endl;
     cout << " " << endl;
@@ -107,7 +122,7 @@ void IOHandler::newGame() {
     cin.clear();
     cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     cout << "Let's Play!" << endl;
-    GameManager::beginGame(player1Name, player2Name);
+    game->beginGame(player1Name, player2Name);
     gameRunning = true;
 }
 
@@ -127,17 +142,24 @@ bool IOHandler::validateName(const string& name) {
 }
 
 void IOHandler::playRound() {
+    // the screen is cleared for the board before anything is written
+    if (ansi && !boardShown)
+        showBoard();
+
     cout << endl;
-    cout << GameManager::currentPlayer->getName() << ", it's your turn "
+    cout << game->currentPlayer->getName() << ", it's your turn "
          << endl;
-    cout << "Score for " << GameManager::player1->getName() << ": "
-         << GameManager::player1->getScore() << endl;
-    cout << "Score for " << GameManager::player2->getName() << ": "
-         << GameManager::player2->getScore() << endl;
+    cout << "Score for " << game->player1->getName() << ": "
+         << game->player1->getScore() << endl;
+    cout << "Score for " << game->player2->getName() << ": "
+         << game->player2->getScore() << endl;
     cout << endl;
-    cout << *GameManager::board << endl;
+    {
+        STATS_TIME(TIMER_RENDER);
+        showBoard();
+    }
     cout << "Your hand is " << endl;
-    cout << *GameManager::currentPlayer->getHand() << endl;
+    cout << *game->currentPlayer->getHand() << endl;
 
     takingInput = true;
     while (takingInput) {
@@ -149,16 +171,20 @@ void IOHandler::playRound() {
             quit();
             cin.clear();
         }
-        command >> operation >> tile >> keywordAT >> pos;
 
-        saveName = tile;
+        {
+            STATS_TIME(TIMER_PARSE);
+            command >> operation >> tile >> keywordAT >> pos;
 
-        transform(
-            operation.begin(), operation.end(), operation.begin(), ::tolower);
-        transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
-        transform(
-            keywordAT.begin(), keywordAT.end(), keywordAT.begin(), ::tolower);
-        transform(pos.begin(), pos.end(), pos.begin(), ::toupper);
+            saveName = tile;
+
+            transform(operation.begin(), operation.end(), operation.begin(),
+                ::tolower);
+            transform(tile.begin(), tile.end(), tile.begin(), ::toupper);
+            transform(keywordAT.begin(), keywordAT.end(), keywordAT.begin(),
+                ::tolower);
+            transform(pos.begin(), pos.end(), pos.begin(), ::toupper);
+        }
 
         if(operation == "save"){
             takingInput = logicHandler(operation, saveName, keywordAT, pos);
@@ -166,6 +192,10 @@ void IOHandler::playRound() {
             takingInput = logicHandler(operation, tile, keywordAT, pos);
         }
     }
+
+    // the game is reset once it is over, so there is nothing left to save
+    if (autoSaver && gameRunning)
+        autoSaver->moveMade(*game, lastMove);
 }
 
 bool IOHandler::logicHandler(const string& operation, const string& tile,
@@ -187,23 +217,26 @@ bool IOHandler::logicHandler(const string& operation, const string& tile,
         }
 
     } else if (operation == "save") {
+        STATS_TIME(TIMER_SAVE);
         gameFileName = gameFileName + ".save";
         std::ofstream file(gameFileName);
-        file << GameManager::player1->getName() << endl;
-        file << GameManager::player1->getScore() << endl;
-        file << *GameManager::player1->getHand()->getTiles() << endl;
-        file << GameManager::player2->getName() << endl;
-        file << GameManager::player2->getScore() << endl;
-        file << *GameManager::player2->getHand()->getTiles() << endl;
-        file << BOARD_LENGTH << "," << BOARD_LENGTH << endl;
-        file << *GameManager::board << endl;
-        file << *GameManager::bag->getTiles() << endl;
-        file << GameManager::currentPlayer->getName() << endl;
+        file << *game->snapshot();
         file.close();
         cout << endl;
         cout << "Game successfully saved" << endl;
         cout << endl;
         takingInput = true;
+    } else if (operation == "hint" && keywordAT.empty() && pos.empty()) {
+        hint(tile);
+        takingInput = true;
+    } else if (operation == "solve" && keywordAT.empty() && pos.empty()) {
+        solve(tile);
+        takingInput = true;
+    } else if (operation == "stats") {
+        cout << endl;
+        Stats::print(cout);
+        cout << endl;
+        takingInput = true;
     } else if (operation == "quit") {
         quit();
         takingInput = false;
@@ -263,17 +296,27 @@ void IOHandler::loadGame() {
 
         cin.clear();
         cin.ignore();
-
-        shared_ptr<PlayerHand> p1Hand = make_shared<PlayerHand>();
-        shared_ptr<PlayerHand> p2Hand = make_shared<PlayerHand>();
-        shared_ptr<Player> p1 = make_shared<Player>("Player1", p1Hand);
-        shared_ptr<Player> p2 = make_shared<Player>("Player2", p2Hand);
-        shared_ptr<TileBag> tileBag = make_shared<TileBag>();
-        shared_ptr<GameBoard> board = make_shared<GameBoard>();
+        STATS_TIME(TIMER_LOAD);
+
+        shared_ptr<Arena> arena = make_shared<Arena>();
+        ArenaAllocator<Tile> tileAllocator(arena);
+        shared_ptr<PlayerHand> p1Hand = allocate_shared<PlayerHand>(
+            ArenaAllocator<PlayerHand>(arena), arena);
+        shared_ptr<PlayerHand> p2Hand = allocate_shared<PlayerHand>(
+            ArenaAllocator<PlayerHand>(arena), arena);
+        shared_ptr<Player> p1 = allocate_shared<Player>(
+            ArenaAllocator<Player>(arena), "Player1", p1Hand);
+        shared_ptr<Player> p2 = allocate_shared<Player>(
+            ArenaAllocator<Player>(arena), "Player2", p2Hand);
+        shared_ptr<TileBag> tileBag = allocate_shared<TileBag>(
+            ArenaAllocator<TileBag>(arena), arena);
+        shared_ptr<GameBoard> board = allocate_shared<GameBoard>(
+            ArenaAllocator<GameBoard>(arena));
         shared_ptr<Player> currentPlayer = nullptr;
 
         int count = 0;
         string text;
+        vector<string> deltas;
             while (getline(file, text)) {
                 text.erase(
                     std::remove(text.begin(), text.end(), '\r'), text.end());
@@ -329,17 +372,18 @@ void IOHandler::loadGame() {
                             }
                         }
                         if (count == 2) {
-                            p1Hand->addTile(
-                                make_shared<Tile>(substr[0], substr[1] - '0'));
+                            p1Hand->addTile(allocate_shared<Tile>(
+                                tileAllocator, substr[0], substr[1] - '0'));
                         }
                         else if (count == 5) {
-                            p2Hand->addTile(
-                                make_shared<Tile>(substr[0], substr[1] - '0'));
+                            p2Hand->addTile(allocate_shared<Tile>(
+                                tileAllocator, substr[0], substr[1] - '0'));
                         }
                         else {
                             if (!substr.empty()) {
-                                tileBag->getTiles()->addBack(make_shared<Tile>(
-                                    substr[0], substr[1] - '0'));
+                                tileBag->getTiles()->addBack(
+                                    allocate_shared<Tile>(tileAllocator,
+                                        substr[0], substr[1] - '0'));
                             }
                         }
                     }
@@ -382,16 +426,22 @@ void IOHandler::loadGame() {
                             : (int)(pos[1] - '0') * 10 + (int)(pos[2] - '0');
                         if (!substr.empty()) {
                             board->placeTile(
-                                make_shared<Tile>(tile[0], tile[1] - '0'), row,
-                                column);
+                                allocate_shared<Tile>(tileAllocator, tile[0],
+                                    tile[1] - '0'), row, column);
                         }
                     }
                     count++;
+                } else if (count > 9 && !text.empty() && !file.eof()) {
+                    // the moves appended after the base, the last of which
+                    // was cut short if it has no line break
+                    deltas.push_back(text);
                 }
             }
-            cout << "Qwirkle game successfully loaded." << endl;
             file.close();
-            GameManager::loadGame(p1, p2, tileBag, board, currentPlayer);
+            game->loadGame(
+                p1, p2, tileBag, board, currentPlayer, arena);
+            replay(deltas);
+            cout << "Qwirkle game successfully loaded." << endl;
             gameRunning = true;
             fileCheck = false;
 
@@ -401,6 +451,37 @@ void IOHandler::loadGame() {
     }
 }
 
+void IOHandler::replay(const vector<string>& deltas) {
+    bool failed = false;
+    game->listener = [&failed](const string& message, State state) {
+        failed = failed || state == PLACE_FAILURE ||
+            state == REPLACE_FAILURE;
+    };
+
+    for (const string& delta : deltas) {
+        size_t at = delta.find('@');
+        Colour colour;
+        Shape shape;
+        size_t row = 0;
+        size_t column = 0;
+        bool valid = parseTile(delta.substr(0, at), colour, shape) &&
+            (at == string::npos ||
+                parsePosition(delta.substr(at + 1), row, column));
+
+        if (valid && at != string::npos)
+            game->placeTile(colour, shape, row, column);
+        else if (valid)
+            game->replaceTile(colour, shape);
+        if (!valid || failed) {
+            game->listener = IOHandler::notify;
+            throw std::invalid_argument(
+                "The move " + delta + " cannot be replayed.");
+        }
+    }
+
+    game->listener = IOHandler::notify;
+}
+
 bool IOHandler::is_empty(std::ifstream& file){
     return file.peek() == std::ifstream::traits_type::eof();
 }
@@ -476,7 +557,8 @@ bool IOHandler::checkTilePosition(const string& position) {
             appended.append(1, num1);
             appended.append(1, num2);
             int combinedNumber = stoi(appended);
-            if (combinedNumber > MAX_BOARD_INDEX ||
+            int boardLength = StandardRules::BOARD_LENGTH;
+            if (combinedNumber >= boardLength ||
                 combinedNumber < MIN_TILE_RANGE) {
                 boolNumber = false;
             } else {
@@ -520,13 +602,104 @@ void IOHandler::placeTile(const string& tile, const string& position) {
         appended.append(1, num2);
         col = stoi(appended);
     }
-    GameManager::placeTile(colour, shape, row, col);
+    lastMove = tile + "@" + formatPosition(row, col);
+    game->placeTile(colour, shape, row, col);
 }
 
 void IOHandler::replaceTile(const string& tile) {
     Colour colour = tile.at(0);
     Shape shape = static_cast<int>(tile.at(1)) - ASCII_NUMERICAL_BEGIN;
-    GameManager::replaceTile(colour, shape);
+    lastMove = tile;
+    game->replaceTile(colour, shape);
+}
+
+void IOHandler::hint(const string& budget) {
+    size_t milliseconds = HINT_BUDGET_MS;
+    if (!budget.empty()) {
+        bool digits = budget.size() <= STRING_SIZE_5 &&
+            std::all_of(budget.begin(), budget.end(), ::isdigit);
+        if (!digits) {
+            cout << ERROR_MESSAGE "Not a valid time budget." << endl;
+            return;
+        }
+        milliseconds = stoul(budget);
+    }
+
+    MoveSearch<StandardRules> search(*game->snapshot());
+    SearchResult result = search.search(
+        std::chrono::milliseconds(milliseconds), HINT_CANDIDATES);
+
+    cout << endl;
+    if (result.candidates.empty()) {
+        cout << "No tile in hand can be placed, replace a tile." << endl;
+    } else {
+        cout << "Best moves searched " << result.depth << " moves ahead in "
+             << std::fixed << std::setprecision(1) << result.milliseconds
+             << " ms:" << endl;
+        for (const Candidate& candidate : result.candidates) {
+            Tile tile(
+                StandardRules::colourAt(
+                    candidate.kind / StandardRules::TYPES),
+                StandardRules::shapeAt(candidate.kind % StandardRules::TYPES));
+            cout << "place " << tile << " at "
+                 << (char)(candidate.row + ASCII_ALPHABET_BEGIN)
+                 << candidate.column << " - scores " << candidate.points
+                 << ", expected " << std::showpos << candidate.expected
+                 << std::noshowpos << endl;
+        }
+        cout << std::defaultfloat;
+    }
+    cout << endl;
+}
+
+void IOHandler::solve(const string& budget) {
+    size_t milliseconds = SOLVE_BUDGET_MS;
+    if (!budget.empty()) {
+        bool digits = budget.size() <= STRING_SIZE_5 &&
+            std::all_of(budget.begin(), budget.end(), ::isdigit);
+        if (!digits) {
+            cout << ERROR_MESSAGE "Not a valid time budget." << endl;
+            return;
+        }
+        milliseconds = stoul(budget);
+    }
+
+    if (!game->bag->getTiles()->isEmpty()) {
+        cout << ERROR_MESSAGE "The bag is not empty yet." << endl;
+        return;
+    }
+
+    EndgameSolver<StandardRules> solver(*game->snapshot());
+    EndgameResult result =
+        solver.solve(std::chrono::milliseconds(milliseconds));
+
+    cout << endl;
+    if (result.solved) {
+        cout << "Solved in " << std::fixed << std::setprecision(1)
+             << result.milliseconds << " ms, you score "
+             << std::showpos << result.margin << std::noshowpos
+             << " more than the opponent from here:" << endl;
+    } else {
+        cout << "Best line searched " << result.depth << " moves ahead in "
+             << std::fixed << std::setprecision(1) << result.milliseconds
+             << " ms, you score " << std::showpos << result.margin
+             << std::noshowpos << " more than the opponent so far:" << endl;
+    }
+    cout << std::defaultfloat;
+
+    for (const EndgameMove& move : result.line) {
+        if (move.kind == LineIndex<StandardRules>::NO_TILE) {
+            cout << "pass" << endl;
+            continue;
+        }
+
+        Tile tile(StandardRules::colourAt(move.kind / StandardRules::TYPES),
+            StandardRules::shapeAt(move.kind % StandardRules::TYPES));
+        cout << "place " << tile << " at "
+             << (char)(move.row + ASCII_ALPHABET_BEGIN) << int(move.column)
+             << " - scores " << int(move.points) << endl;
+    }
+    cout << endl;
 }
 
 void IOHandler::notify(const string& message, State state) {
@@ -545,29 +718,64 @@ void IOHandler::notify(const string& message, State state) {
         takingInput = false;
     } else if (state == GAME_OVER) {
         cout << endl;
-        cout << *GameManager::board << endl;
+        showBoard();
+        if (ansi)
+            cout << ANSI_RELEASE_SCREEN;
         cout << "Game Over" << endl;
-        cout << "Score for " << GameManager::player1->getName() << " : "
-             << GameManager::player1->getScore() << endl;
-        cout << "Score for " << GameManager::player2->getName() << " : "
-             << GameManager::player2->getScore() << endl;
-        if (GameManager::player1->getScore() >
-            GameManager::player2->getScore()) {
-            cout << "Player " << GameManager::player1->getName() << " won!"
+        cout << "Score for " << game->player1->getName() << " : "
+             << game->player1->getScore() << endl;
+        cout << "Score for " << game->player2->getName() << " : "
+             << game->player2->getScore() << endl;
+        if (game->player1->getScore() >
+            game->player2->getScore()) {
+            cout << "Player " << game->player1->getName() << " won!"
                  << endl;
         } else {
-            cout << "Player " << GameManager::player2->getName() << " won!"
+            cout << "Player " << game->player2->getName() << " won!"
                  << endl;
         }
         cout << "Goodbye" << endl;
         takingInput = false;
         gameRunning = false;
-        GameManager::resetGame();
+        game->resetGame();
+    }
+}
+
+void IOHandler::enableAutosave(
+    const string& fileName, size_t interval, bool deltas) {
+    autoSaver = make_shared<AutoSaver>(fileName, interval, deltas);
+}
+
+void IOHandler::showBoard() {
+    if (!ansi) {
+        // an empty board is shown whole, as a tile can go anywhere on it
+        if (crop && !game->board->isEmpty())
+            game->board->printRegion(cout, game->board->getBounds(1));
+        else
+            cout << *game->board;
+        cout << endl;
+        return;
+    }
+
+    // the board takes its rows and two lines of header, and a blank line
+    // sets it apart from the scrolling region under it
+    size_t below = StandardRules::BOARD_LENGTH + 4;
+    if (!boardShown) {
+        cout << ANSI_CLEAR_SCREEN << *game->board << "\033[" << below
+             << "r\033[" << below << ";1H" << std::flush;
+        boardShown = true;
+    } else {
+        game->board->printChanges(cout, 1);
     }
 }
 
 void IOHandler::quit() {
-    GameManager::resetGame();
+    if (ansi)
+        cout << ANSI_RELEASE_SCREEN;
+    if (Stats::dumpOnExit)
+        Stats::print(cerr);
+
+    game->resetGame();
     cout << "Goodbye" << endl;
     exit(EXIT_SUCCESS);
 }
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "GameManager.h"
+#include "AutoSaver.h"
 
 class IOHandler {
 public:
@@ -82,11 +83,20 @@ public:
 /**
  *
  * Game Loader
- * Loads .save file based on user input
+ * Loads .save file based on user input, replaying any moves appended to it
  *
  **/
     static void loadGame();
 
+/**
+ * Replays the moves appended to a save on the loaded game, quietly
+ *
+ * @parms deltas - the moves, tile@location for a placement or the tile for
+ * a replacement
+ * @throws invalid_argument if a move cannot be made
+ **/
+    static void replay(const vector<string>& deltas);
+
     static bool is_empty(std::ifstream& file);
 
 /**
@@ -127,6 +137,29 @@ public:
 
     static void replaceTile(const string& tile);
 
+/**
+ * Searches for the best placements within a time budget and prints them
+ *
+ * @parms budget - the budget in milliseconds, the default if empty
+ *
+ **/
+    static void hint(const string& budget);
+
+/**
+ * Solves the rest of the game once the bag is empty and prints the best line
+ *
+ * @parms budget - the budget in milliseconds, the default if empty
+ *
+ **/
+    static void solve(const string& budget);
+
+/**
+ * Prints the board, cropped to the tiles and the cells around them if asked,
+ * or in ANSI mode draws it once at the top of the screen with the rest
+ * scrolling under it and redraws only the cells placed in
+ **/
+    static void showBoard();
+
 /**
  *Prints out messages and notifies the players about their operation
  *
@@ -140,9 +173,35 @@ public:
  **/
     static void quit();
 
+/**
+ * Configures saving the game in the background every few moves
+ *
+ * @parms fileName - the name of the save file
+ * @parms interval - the number of moves between saves in full
+ * @parms deltas - whether to append each move to the save in between
+ **/
+    static void enableAutosave(const string& fileName, size_t interval,
+        bool deltas);
+
     static bool gameRunning;
 
+    // whether the board is kept in place and updated with ANSI escapes, and
+    // whether it has been drawn yet
+    static bool ansi;
+
+    static bool boardShown;
+
+    // whether the board is printed cropped, unless it is kept in place
+    static bool crop;
+
     static bool takingInput;
+
+    static shared_ptr<AutoSaver> autoSaver;
+
+    // the last move tried, as a delta for the autosaver
+    static string lastMove;
+
+    static shared_ptr<GameManager> game;
 };
 
 #endif // !IO_HANDLER
@@ -0,0 +1,288 @@
+#include "LineIndex.h"
+
+template <class Rules>
+LineIndex<Rules>::LineIndex() : tileCount(0), runCount(0), frontierSize(0) {
+    kinds.fill(NO_TILE);
+    runIds.fill({{0, 0}});
+    runs.fill({LineTable<Rules>::EMPTY, 0});
+    frontierSlots.fill(Rules::CELLS);
+}
+
+template <class Rules>
+void LineIndex<Rules>::place(size_t kind, size_t row, size_t column) {
+    apply(kind, row * Rules::BOARD_LENGTH + column, nullptr);
+}
+
+template <class Rules>
+void LineIndex<Rules>::push(size_t kind, size_t row, size_t column) {
+    history.emplace_back();
+    apply(kind, row * Rules::BOARD_LENGTH + column, &history.back());
+}
+
+template <class Rules>
+void LineIndex<Rules>::pop() {
+    const Placement& record = history.back();
+    size_t cell = record.cell;
+
+    for (Axis axis : {VERTICAL, HORIZONTAL}) {
+        uint16_t id = record.runIds[axis];
+        size_t next = cell;
+        for (size_t i = 0; i < record.relabelled[axis]; ++i) {
+            next = neighbour(next, axis, 1);
+            runIds[next][axis] = record.merged[axis];
+        }
+
+        runs[id] = record.previous[axis];
+        if (record.created[axis])
+            --runCount;
+        runIds[cell][axis] = 0;
+    }
+
+    // the added cells were appended, so they are the last in the list
+    for (size_t i = 0; i < record.frontierAdded; ++i)
+        frontierSlots[frontier[--frontierSize]] = Rules::CELLS;
+
+    // the cell that took the removed cell's slot goes back to the end
+    size_t slot = record.frontierSlot;
+    if (slot != Rules::CELLS) {
+        if (slot < frontierSize) {
+            uint16_t moved = frontier[slot];
+            frontier[frontierSize] = moved;
+            frontierSlots[moved] = frontierSize;
+        }
+        frontier[slot] = cell;
+        frontierSlots[cell] = slot;
+        ++frontierSize;
+    }
+
+    kinds[cell] = NO_TILE;
+    --tileCount;
+    history.pop_back();
+}
+
+template <class Rules>
+uint8_t LineIndex<Rules>::kindAt(size_t row, size_t column) const {
+    return kinds[row * Rules::BOARD_LENGTH + column];
+}
+
+template <class Rules>
+Run LineIndex<Rules>::runAt(size_t row, size_t column, Axis axis) const {
+    return runs[runIds[row * Rules::BOARD_LENGTH + column][axis]];
+}
+
+template <class Rules>
+Run LineIndex<Rules>::adjacentRun(
+    size_t row, size_t column, Axis axis) const {
+    size_t cell = row * Rules::BOARD_LENGTH + column;
+    Run line = runs[neighbourRun(cell, axis, -1)];
+    const Run& after = runs[neighbourRun(cell, axis, 1)];
+    line.descriptor = LineTable<Rules>::join(line.descriptor, after.descriptor);
+    line.length += after.length;
+
+    return line;
+}
+
+template <class Rules>
+typename LineIndex<Rules>::KindMask LineIndex<Rules>::acceptedKinds(
+    size_t row, size_t column) const {
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH ||
+        kinds[row * Rules::BOARD_LENGTH + column] != NO_TILE)
+        return 0;
+
+    Run horizontal = adjacentRun(row, column, HORIZONTAL);
+    Run vertical = adjacentRun(row, column, VERTICAL);
+    if (tileCount != 0 && horizontal.length == 0 && vertical.length == 0)
+        return 0;
+
+    return LineTable<Rules>::accepts(horizontal.descriptor) &
+        LineTable<Rules>::accepts(vertical.descriptor);
+}
+
+template <class Rules>
+bool LineIndex<Rules>::isLegal(
+    size_t kind, size_t row, size_t column) const {
+    return kind < Rules::KINDS &&
+        (acceptedKinds(row, column) & (KindMask(1) << kind)) != 0;
+}
+
+template <class Rules>
+size_t LineIndex<Rules>::score(
+    size_t kind, size_t row, size_t column) const {
+    // the first tile scores a point of its own
+    size_t points = tileCount == 0 ? 1 : 0;
+    for (Axis axis : {HORIZONTAL, VERTICAL}) {
+        Run line = adjacentRun(row, column, axis);
+        if (line.length != 0)
+            points += line.length + 1;
+        if (LineTable<Rules>::isQwirkle(
+            LineTable<Rules>::extend(line.descriptor, kind)))
+            points += Rules::SCORE_BONUS;
+    }
+
+    return points;
+}
+
+template <class Rules>
+typename LineIndex<Rules>::Fit LineIndex<Rules>::fit(
+    size_t row, size_t column, KindMask hand) const {
+    Fit fit = {0, 0};
+    if (row >= Rules::BOARD_LENGTH || column >= Rules::BOARD_LENGTH ||
+        kinds[row * Rules::BOARD_LENGTH + column] != NO_TILE)
+        return fit;
+
+    Run horizontal = adjacentRun(row, column, HORIZONTAL);
+    Run vertical = adjacentRun(row, column, VERTICAL);
+    if (tileCount != 0 && horizontal.length == 0 && vertical.length == 0)
+        return fit;
+
+    fit.kinds = hand & LineTable<Rules>::accepts(horizontal.descriptor) &
+        LineTable<Rules>::accepts(vertical.descriptor);
+    if (fit.kinds == 0)
+        return fit;
+
+    // the first tile scores a point of its own
+    size_t points = tileCount == 0 ? 1 : 0;
+    for (const Run& line : {horizontal, vertical}) {
+        if (line.length != 0)
+            points += line.length + 1;
+        if (line.length + size_t(1) == Rules::MAX_LINE_SIZE)
+            points += Rules::SCORE_BONUS;
+    }
+    fit.points = uint8_t(points);
+
+    return fit;
+}
+
+template <class Rules>
+bool LineIndex<Rules>::acceptsAny(KindMask kinds) const {
+    bool accepted = tileCount == 0 && kinds != 0;
+    for (size_t i = 0; i < frontierSize && !accepted; ++i) {
+        accepted = (kinds & acceptedKinds(
+            frontier[i] / Rules::BOARD_LENGTH,
+            frontier[i] % Rules::BOARD_LENGTH)) != 0;
+    }
+
+    return accepted;
+}
+
+template <class Rules>
+size_t LineIndex<Rules>::getFrontierSize() const { return frontierSize; }
+
+template <class Rules>
+size_t LineIndex<Rules>::getFrontierCell(size_t index) const {
+    return frontier[index];
+}
+
+template <class Rules>
+size_t LineIndex<Rules>::getTileCount() const { return tileCount; }
+
+template <class Rules>
+void LineIndex<Rules>::apply(size_t kind, size_t cell, Placement* record) {
+    kinds[cell] = kind;
+    ++tileCount;
+
+    size_t slot = removeFromFrontier(cell);
+    size_t added = 0;
+    for (Axis axis : {HORIZONTAL, VERTICAL}) {
+        added += addToFrontier(neighbour(cell, axis, -1));
+        added += addToFrontier(neighbour(cell, axis, 1));
+    }
+
+    if (record != nullptr) {
+        record->cell = cell;
+        record->frontierSlot = slot;
+        record->frontierAdded = added;
+    }
+
+    for (Axis axis : {HORIZONTAL, VERTICAL}) {
+        uint16_t before = neighbourRun(cell, axis, -1);
+        uint16_t after = neighbourRun(cell, axis, 1);
+        uint16_t id = before != 0 ? before : after;
+        bool created = id == 0;
+        if (created)
+            id = ++runCount;
+
+        Run& run = runs[id];
+        if (record != nullptr) {
+            record->created[axis] = created;
+            record->runIds[axis] = id;
+            record->previous[axis] = run;
+            record->merged[axis] = 0;
+            record->relabelled[axis] = 0;
+        }
+
+        run.descriptor = LineTable<Rules>::extend(run.descriptor, kind);
+        ++run.length;
+        runIds[cell][axis] = id;
+
+        // the tile joins two runs, the later one is relabelled as the earlier
+        if (before != 0 && after != 0) {
+            run.descriptor =
+                LineTable<Rules>::join(run.descriptor, runs[after].descriptor);
+            run.length += runs[after].length;
+
+            size_t next = cell;
+            size_t relabelled = 0;
+            do {
+                next = neighbour(next, axis, 1);
+                runIds[next][axis] = id;
+                ++relabelled;
+            } while (neighbourRun(next, axis, 1) == after);
+
+            if (record != nullptr) {
+                record->merged[axis] = after;
+                record->relabelled[axis] = relabelled;
+            }
+        }
+    }
+}
+
+template <class Rules>
+uint16_t LineIndex<Rules>::neighbourRun(
+    size_t cell, Axis axis, int step) const {
+    size_t other = neighbour(cell, axis, step);
+    return other < Rules::CELLS ? runIds[other][axis] : 0;
+}
+
+template <class Rules>
+size_t LineIndex<Rules>::neighbour(size_t cell, Axis axis, int step) {
+    // stepping back from the first row or column wraps past the board
+    size_t row = cell / Rules::BOARD_LENGTH;
+    size_t column = cell % Rules::BOARD_LENGTH;
+    if (axis == VERTICAL)
+        row += step;
+    else
+        column += step;
+
+    return row < Rules::BOARD_LENGTH && column < Rules::BOARD_LENGTH
+        ? row * Rules::BOARD_LENGTH + column : Rules::CELLS;
+}
+
+template <class Rules>
+bool LineIndex<Rules>::addToFrontier(size_t cell) {
+    bool added = cell < Rules::CELLS && kinds[cell] == NO_TILE &&
+        frontierSlots[cell] == Rules::CELLS;
+    if (added) {
+        frontierSlots[cell] = frontierSize;
+        frontier[frontierSize++] = cell;
+    }
+
+    return added;
+}
+
+template <class Rules>
+size_t LineIndex<Rules>::removeFromFrontier(size_t cell) {
+    size_t slot = frontierSlots[cell];
+    if (slot != Rules::CELLS) {
+        // the last cell in the list takes the removed cell's slot
+        uint16_t last = frontier[--frontierSize];
+        frontier[slot] = last;
+        frontierSlots[last] = slot;
+        frontierSlots[cell] = Rules::CELLS;
+    }
+
+    return slot;
+}
+
+template class LineIndex<StandardRules>;
+template class LineIndex<ExtendedRules>;
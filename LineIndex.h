@@ -0,0 +1,245 @@
+#ifndef LINE_INDEX_H
+#define LINE_INDEX_H
+
+#include "LineTable.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using std::array;
+using std::vector;
+
+/**
+ * The axes a line of tiles can run along.
+ */
+enum Axis {
+    HORIZONTAL,
+    VERTICAL
+};
+
+/**
+ * A maximal run of adjacent tiles along one axis, its descriptor gives the
+ * attribute the tiles share and a mask of the values of the other.
+ */
+struct Run {
+    uint16_t descriptor;
+    uint8_t length;
+};
+
+/**
+ * @note
+ * The kinds on a board with the runs they form and the frontier of empty
+ * cells next to them, enough to validate and score a placement in O(1)
+ * without touching a tile. Queries never throw or allocate, and a placement
+ * can be pushed and popped again, so a search can play moves out on a copy.
+ */
+template <class Rules>
+class LineIndex {
+public:
+    typedef typename LineTable<Rules>::KindMask KindMask;
+
+    // the kind of an empty cell
+    static constexpr uint8_t NO_TILE = UINT8_MAX;
+
+    /**
+     * The kinds of a hand that fit a cell and the points each of them
+     * scores there.
+     */
+    struct Fit {
+        KindMask kinds;
+        uint8_t points;
+    };
+
+    static_assert(Rules::KINDS < NO_TILE, "kinds must fit 8 bits");
+    static_assert(2 * Rules::CELLS < UINT16_MAX, "run IDs must fit 16 bits");
+
+    /**
+     * Construct the index of an empty board.
+     */
+    LineIndex();
+
+    /**
+     * Place a kind in an empty cell, for good.
+     *
+     * @param kind - the kind
+     * @param row,column - the location, which must be on the board
+     */
+    void place(size_t kind, size_t row, size_t column);
+
+    /**
+     * Place a kind in an empty cell so that it can be popped again.
+     *
+     * @param kind - the kind
+     * @param row,column - the location, which must be on the board
+     */
+    void push(size_t kind, size_t row, size_t column);
+
+    /**
+     * Undo the last pushed placement.
+     */
+    void pop();
+
+    /**
+     * Get the kind in a cell.
+     *
+     * @param row,column - the location, which must be on the board
+     * @return the kind, NO_TILE if the cell is empty
+     */
+    uint8_t kindAt(size_t row, size_t column) const;
+
+    /**
+     * Get the run through an occupied cell.
+     *
+     * @param row,column - the location, which must be on the board
+     * @param axis - the axis of the run
+     * @return the run, of length 0 if the cell is empty
+     */
+    Run runAt(size_t row, size_t column, Axis axis) const;
+
+    /**
+     * Get the runs either side of an empty cell taken together, which is the
+     * line a tile placed there would join less the tile itself.
+     *
+     * @param row,column - the location, which must be on the board
+     * @param axis - the axis of the runs
+     * @return the joined run, of length 0 if there are no adjacent tiles
+     */
+    Run adjacentRun(size_t row, size_t column, Axis axis) const;
+
+    /**
+     * Get the kinds that could be placed in a cell.
+     *
+     * @param row,column - the location
+     * @return a mask of the kinds, empty if the location is off the board,
+     * occupied or not next to a tile while the board has tiles
+     */
+    KindMask acceptedKinds(size_t row, size_t column) const;
+
+    /**
+     * Query whether a kind could be placed in a cell.
+     */
+    bool isLegal(size_t kind, size_t row, size_t column) const;
+
+    /**
+     * Get the points a legal placement scores, including QWIRKLE bonuses.
+     *
+     * @param kind - the kind
+     * @param row,column - the location
+     */
+    size_t score(size_t kind, size_t row, size_t column) const;
+
+    /**
+     * Test every kind of a hand against a cell at once. A kind that fits
+     * joins the same runs as any other that fits, and completes a QWIRKLE
+     * exactly when the run it joins is one short, so every kind that fits
+     * scores the same and the runs are only looked up once.
+     *
+     * @param row,column - the location
+     * @param hand - a mask of the kinds to test
+     * @return the kinds that fit, as acceptedKinds would give them, and the
+     * points score would give for each, 0 if none fits
+     */
+    Fit fit(size_t row, size_t column, KindMask hand) const;
+
+    /**
+     * Query whether a tile of any of the given kinds could be placed, only
+     * the empty cells next to a tile are checked.
+     *
+     * @param kinds - a mask with a bit set for each kind
+     * @return true if some kind fits some cell, any kind fits an empty board
+     */
+    bool acceptsAny(KindMask kinds) const;
+
+    /**
+     * Get the number of empty cells next to a tile.
+     */
+    size_t getFrontierSize() const;
+
+    /**
+     * Get an empty cell next to a tile, in no particular order.
+     *
+     * @param index - between 0 and getFrontierSize() - 1
+     * @return the cell as row * Rules::BOARD_LENGTH + column
+     */
+    size_t getFrontierCell(size_t index) const;
+
+    /**
+     * Get the number of tiles placed.
+     */
+    size_t getTileCount() const;
+
+private:
+    /**
+     * What a placement changed, so that it can be undone.
+     */
+    struct Placement {
+        uint16_t cell;
+        uint16_t frontierSlot;
+        uint8_t frontierAdded;
+        bool created[2];
+        uint16_t runIds[2];
+        Run previous[2];
+        uint16_t merged[2];
+        uint8_t relabelled[2];
+    };
+
+    /**
+     * Place a kind, recording the changes if there is a record.
+     */
+    void apply(size_t kind, size_t cell, Placement* record);
+
+    /**
+     * Get the ID of the run through the cell a step along an axis, 0 if that
+     * cell is empty or off the board.
+     */
+    uint16_t neighbourRun(size_t cell, Axis axis, int step) const;
+
+    /**
+     * Get the cell a step along an axis, CELLS if it is off the board.
+     */
+    static size_t neighbour(size_t cell, Axis axis, int step);
+
+    /**
+     * Add an empty cell to the frontier, unless it is off the board or in it.
+     *
+     * @return true if the cell was added
+     */
+    bool addToFrontier(size_t cell);
+
+    /**
+     * Remove a cell from the frontier, if it is in it.
+     *
+     * @return the slot the cell had, CELLS if it was not in the frontier
+     */
+    size_t removeFromFrontier(size_t cell);
+
+    array<uint8_t, Rules::CELLS> kinds;
+    size_t tileCount;
+
+    /*
+     * every occupied cell holds the ID of its run along each axis, a
+     * placement creates or extends one run per axis and merges the runs
+     * either side of it when it joins two, so there are at most two runs per
+     * cell and ID 0 is kept for no run
+     */
+    array<array<uint16_t, 2>, Rules::CELLS> runIds;
+    array<Run, 2 * Rules::CELLS + 1> runs;
+    size_t runCount;
+
+    /*
+     * the frontier is every empty cell next to a tile, the only cells a tile
+     * can be placed in, kept as an unordered list of cells with the slot of
+     * each cell in it, or CELLS if it is not in the frontier
+     */
+    array<uint16_t, Rules::CELLS> frontier;
+    array<uint16_t, Rules::CELLS> frontierSlots;
+    size_t frontierSize;
+
+    vector<Placement> history;
+};
+
+template <class Rules>
+constexpr uint8_t LineIndex<Rules>::NO_TILE;
+
+#endif // !LINE_INDEX_H
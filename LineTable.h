@@ -0,0 +1,298 @@
+#ifndef LINE_TABLE_H
+#define LINE_TABLE_H
+
+#include "TileBag.h"
+#include "Rules.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @note
+ * A line of tiles is described by a single number. The empty line is 0, a
+ * line of one tile is 1 + its kind, since it could still become either kind
+ * of line, and a longer line is the attribute its tiles share, the value of
+ * that attribute and a mask of the other attribute's values present. Every
+ * legal line has exactly one descriptor and its length is the number of bits
+ * in the mask, so extending a line by a tile is a lookup in a table built at
+ * compile time, as is whether two tiles may share a line.
+ */
+template <class Rules>
+struct LineDescriptors {
+    static constexpr size_t TYPES = Rules::TYPES;
+    static constexpr size_t KINDS = Rules::KINDS;
+    static constexpr size_t MASKS = size_t(1) << Rules::TYPES;
+
+    // attributes a line of two or more tiles can share
+    static constexpr size_t SHARES_COLOUR = 0;
+    static constexpr size_t SHARES_SHAPE = 1;
+
+    static constexpr uint16_t EMPTY = 0;
+    static constexpr uint16_t FIRST_SINGLE = 1;
+    static constexpr uint16_t FIRST_LINE = FIRST_SINGLE + KINDS;
+    static constexpr size_t COUNT = FIRST_LINE + 2 * TYPES * MASKS;
+
+    // the descriptor of any line that breaks the rules, it only extends to
+    // itself so a line can be folded tile by tile without checking
+    static constexpr uint16_t ILLEGAL = COUNT;
+
+    static_assert(COUNT < UINT16_MAX, "line descriptors must fit 16 bits");
+
+    // a set of kinds, one bit per kind
+    typedef uint64_t KindMask;
+
+    static_assert(KINDS <= 64, "a kind mask must fit 64 bits");
+
+    /**
+     * Get the descriptor of a line of two or more tiles.
+     *
+     * @param attribute - SHARES_COLOUR or SHARES_SHAPE
+     * @param value - the index of the shared colour or shape
+     * @param mask - a mask of the other attribute's indices in the line
+     */
+    static constexpr uint16_t line(
+        size_t attribute, size_t value, size_t mask) {
+        return FIRST_LINE + (attribute * TYPES + value) * MASKS + mask;
+    }
+};
+
+/**
+ * Whether two kinds may share a line: distinct, with the same colour or the
+ * same shape.
+ */
+template <class Rules>
+struct PairTable {
+    bool compatible[Rules::KINDS][Rules::KINDS];
+};
+
+/**
+ * The descriptor each line extends to with each kind, the length of the line
+ * each descriptor describes and the kinds that extend it, with a row for
+ * ILLEGAL.
+ */
+template <class Rules>
+struct TransitionTable {
+    uint16_t next[LineDescriptors<Rules>::COUNT + 1][Rules::KINDS];
+    uint8_t length[LineDescriptors<Rules>::COUNT + 1];
+    typename LineDescriptors<Rules>::KindMask
+        accepts[LineDescriptors<Rules>::COUNT + 1];
+};
+
+template <class Rules>
+constexpr PairTable<Rules> buildPairTable() {
+    PairTable<Rules> table{};
+    for (size_t a = 0; a < Rules::KINDS; ++a) {
+        for (size_t b = 0; b < Rules::KINDS; ++b) {
+            table.compatible[a][b] = a != b &&
+                (a / Rules::TYPES == b / Rules::TYPES ||
+                 a % Rules::TYPES == b % Rules::TYPES);
+        }
+    }
+
+    return table;
+}
+
+inline constexpr size_t countBits(size_t mask) {
+    size_t bits = 0;
+    for (; mask != 0; mask &= mask - 1)
+        ++bits;
+
+    return bits;
+}
+
+template <class Rules>
+constexpr TransitionTable<Rules> buildTransitionTable() {
+    typedef LineDescriptors<Rules> D;
+    PairTable<Rules> pairs = buildPairTable<Rules>();
+    TransitionTable<Rules> table{};
+
+    for (size_t kind = 0; kind < D::KINDS; ++kind) {
+        table.next[D::EMPTY][kind] = D::FIRST_SINGLE + kind;
+        table.next[D::ILLEGAL][kind] = D::ILLEGAL;
+    }
+    table.length[D::EMPTY] = 0;
+    table.length[D::ILLEGAL] = 0;
+
+    // a single tile becomes a line of whichever attribute it shares
+    for (size_t single = 0; single < D::KINDS; ++single) {
+        size_t colour = single / D::TYPES;
+        size_t shape = single % D::TYPES;
+        table.length[D::FIRST_SINGLE + single] = 1;
+
+        for (size_t kind = 0; kind < D::KINDS; ++kind) {
+            size_t kindColour = kind / D::TYPES;
+            size_t kindShape = kind % D::TYPES;
+            uint16_t next = D::ILLEGAL;
+            if (pairs.compatible[single][kind] && kindColour == colour) {
+                next = D::line(D::SHARES_COLOUR, colour,
+                    (size_t(1) << shape) | (size_t(1) << kindShape));
+            } else if (pairs.compatible[single][kind]) {
+                next = D::line(D::SHARES_SHAPE, shape,
+                    (size_t(1) << colour) | (size_t(1) << kindColour));
+            }
+            table.next[D::FIRST_SINGLE + single][kind] = next;
+        }
+    }
+
+    // a longer line only takes its shared attribute with a new other one
+    for (size_t attribute = 0; attribute < 2; ++attribute) {
+        for (size_t value = 0; value < D::TYPES; ++value) {
+            for (size_t mask = 0; mask < D::MASKS; ++mask) {
+                uint16_t descriptor = D::line(attribute, value, mask);
+                table.length[descriptor] = countBits(mask);
+
+                for (size_t kind = 0; kind < D::KINDS; ++kind) {
+                    size_t shared = attribute == D::SHARES_COLOUR
+                        ? kind / D::TYPES : kind % D::TYPES;
+                    size_t other = attribute == D::SHARES_COLOUR
+                        ? kind % D::TYPES : kind / D::TYPES;
+                    size_t bit = size_t(1) << other;
+                    table.next[descriptor][kind] =
+                        shared == value && (mask & bit) == 0
+                        ? D::line(attribute, value, mask | bit) : D::ILLEGAL;
+                }
+            }
+        }
+    }
+
+    for (size_t descriptor = 0; descriptor < D::COUNT; ++descriptor) {
+        for (size_t kind = 0; kind < D::KINDS; ++kind) {
+            if (table.next[descriptor][kind] != D::ILLEGAL)
+                table.accepts[descriptor] |= typename D::KindMask(1) << kind;
+        }
+    }
+
+    return table;
+}
+
+/**
+ * Compile-time lookup tables for the line rules of a rule set.
+ */
+template <class Rules>
+class LineTable : public LineDescriptors<Rules> {
+public:
+    typedef LineDescriptors<Rules> Descriptors;
+
+    /**
+     * Query whether two kinds may share a line.
+     */
+    static bool compatible(size_t kind, size_t other) {
+        return kind < Rules::KINDS && other < Rules::KINDS &&
+            PAIRS.compatible[kind][other];
+    }
+
+    /**
+     * Get the descriptor of a line extended by a tile.
+     *
+     * @param descriptor - the line's descriptor
+     * @param kind - the tile's kind
+     * @return the extended line's descriptor, ILLEGAL if the tile breaks it
+     */
+    static uint16_t extend(uint16_t descriptor, size_t kind) {
+        return kind < Rules::KINDS
+            ? TRANSITIONS.next[descriptor][kind] : Descriptors::ILLEGAL;
+    }
+
+    /**
+     * Get the kinds that may extend a line.
+     *
+     * @param descriptor - the line's descriptor
+     * @return a mask with a bit set for each kind the line accepts
+     */
+    static typename Descriptors::KindMask accepts(uint16_t descriptor) {
+        return TRANSITIONS.accepts[descriptor];
+    }
+
+    /**
+     * Get the descriptor of the tiles of two lines taken together, such as
+     * the runs either side of an empty cell.
+     *
+     * @param descriptor,other - the lines' descriptors
+     * @return the joined descriptor, ILLEGAL if the tiles cannot share a line
+     */
+    static uint16_t join(uint16_t descriptor, uint16_t other) {
+        if (other == Descriptors::EMPTY)
+            return descriptor;
+        else if (descriptor == Descriptors::EMPTY)
+            return other;
+        else if (descriptor == Descriptors::ILLEGAL ||
+                 other == Descriptors::ILLEGAL)
+            return Descriptors::ILLEGAL;
+        else if (other < Descriptors::FIRST_LINE)
+            return extend(descriptor, other - Descriptors::FIRST_SINGLE);
+        else if (descriptor < Descriptors::FIRST_LINE)
+            return extend(other, descriptor - Descriptors::FIRST_SINGLE);
+
+        // two lines join if they share the same attribute value and no tile
+        size_t offset = descriptor - Descriptors::FIRST_LINE;
+        size_t otherOffset = other - Descriptors::FIRST_LINE;
+        size_t group = offset / Descriptors::MASKS;
+        size_t mask = offset % Descriptors::MASKS;
+        size_t otherMask = otherOffset % Descriptors::MASKS;
+
+        return group == otherOffset / Descriptors::MASKS &&
+            (mask & otherMask) == 0
+            ? Descriptors::FIRST_LINE + group * Descriptors::MASKS +
+                (mask | otherMask)
+            : Descriptors::ILLEGAL;
+    }
+
+    /**
+     * Get the number of tiles in the line a descriptor describes.
+     */
+    static size_t length(uint16_t descriptor) {
+        return TRANSITIONS.length[descriptor];
+    }
+
+    /**
+     * Query whether a descriptor describes a QWIRKLE.
+     */
+    static bool isQwirkle(uint16_t descriptor) {
+        return length(descriptor) == Rules::MAX_LINE_SIZE;
+    }
+
+    /**
+     * Get the descriptor of a line of tiles.
+     *
+     * @param line - the tiles of the line
+     * @return the descriptor, ILLEGAL if the line breaks the rules
+     */
+    static uint16_t describe(const TileList& line) {
+        uint16_t descriptor = Descriptors::EMPTY;
+        for (const shared_ptr<Tile>& tile : line)
+            descriptor = extend(descriptor, Rules::kindOf(*tile));
+
+        return descriptor;
+    }
+
+    static constexpr PairTable<Rules> PAIRS = buildPairTable<Rules>();
+    static constexpr TransitionTable<Rules> TRANSITIONS =
+        buildTransitionTable<Rules>();
+};
+
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::TYPES;
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::KINDS;
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::MASKS;
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::SHARES_COLOUR;
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::SHARES_SHAPE;
+template <class Rules>
+constexpr uint16_t LineDescriptors<Rules>::EMPTY;
+template <class Rules>
+constexpr uint16_t LineDescriptors<Rules>::FIRST_SINGLE;
+template <class Rules>
+constexpr uint16_t LineDescriptors<Rules>::FIRST_LINE;
+template <class Rules>
+constexpr size_t LineDescriptors<Rules>::COUNT;
+template <class Rules>
+constexpr uint16_t LineDescriptors<Rules>::ILLEGAL;
+template <class Rules>
+constexpr PairTable<Rules> LineTable<Rules>::PAIRS;
+template <class Rules>
+constexpr TransitionTable<Rules> LineTable<Rules>::TRANSITIONS;
+
+#endif // !LINE_TABLE_H
@@ -1,34 +1,137 @@
-
 #ifndef ASSIGN2_LINKEDLIST_H
 #define ASSIGN2_LINKEDLIST_H
 
 #include "Node.h"
+#include "Arena.h"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+
+using std::ostream;
+
+template <class T>
+class LinkedList;
+
+/**
+ * A bidirectional iterator over a LinkedList, Value is T or const T.
+ */
+template <class T, class Value>
+class ListIterator {
+public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Value* pointer;
+    typedef Value& reference;
+
+    ListIterator(Node<T>* node, const LinkedList<T>* list)
+        : node(node), list(list) {}
+
+    /**
+     * Allow an iterator to be used where a const iterator is expected.
+     */
+    operator ListIterator<T, const T>() const {
+        return ListIterator<T, const T>(node, list);
+    }
+
+    reference operator*() const { return node->value; }
+
+    pointer operator->() const { return &node->value; }
+
+    ListIterator& operator++() {
+        node = node->next;
+        return *this;
+    }
+
+    ListIterator operator++(int) {
+        ListIterator previous = *this;
+        node = node->next;
+        return previous;
+    }
 
+    // decrementing the end iterator moves to the tail
+    ListIterator& operator--() {
+        node = node == nullptr ? list->tail : node->previous;
+        return *this;
+    }
+
+    ListIterator operator--(int) {
+        ListIterator next = *this;
+        --*this;
+        return next;
+    }
+
+    bool operator==(const ListIterator& other) const {
+        return node == other.node;
+    }
+
+    bool operator!=(const ListIterator& other) const {
+        return node != other.node;
+    }
+
+private:
+    Node<T>* node;
+    const LinkedList<T>* list;
+
+    friend class LinkedList<T>;
+};
+
+/**
+ * @note
+ * A doubly linked list with raw links between nodes. Removed nodes are kept
+ * on a free list and reused by later insertions, so a list that shrinks and
+ * grows again does not allocate. Nodes are allocated from the given arena, or
+ * the heap if there is none.
+ */
+template <class T>
 class LinkedList {
 public:
+    typedef ListIterator<T, T> iterator;
+    typedef ListIterator<T, const T> const_iterator;
+
+    /**
+     * Construct a LinkedList with default head and tail references, nodes are
+     * allocated from the given arena or the heap if there is none.
+     */
+    explicit LinkedList(const shared_ptr<Arena>& arena = nullptr);
+
+    /**
+     * Copy constructor, copies the values into nodes of its own.
+     */
+    LinkedList(const LinkedList& other);
+
     /**
-     * Construct a LinkedList with default head and tail references.
+     * Copy the values into nodes allocated from the given arena, or the heap
+     * if there is none.
      */
-    LinkedList();
+    LinkedList(const LinkedList& other, const shared_ptr<Arena>& arena);
 
     /**
-     * Destructor to free up all Node elements.
+     * Copy assignment, replaces all values with copies of the other's values.
+     */
+    LinkedList& operator=(const LinkedList& other);
+
+    /**
+     * Destructor to free up all Node elements, including pooled ones.
      */
     ~LinkedList();
 
     /**
      * Add an element to the front.
      *
-     * @param tile - a pointer to the tile to be added
+     * @param value - the value to be added
      */
-    void addFront(const shared_ptr<Tile>& tile);
+    void addFront(const T& value);
 
     /**
      * Add an element to the back.
      *
-     * @param tile - a pointer to the tile to be added
+     * @param value - the value to be added
      */
-    void addBack(const shared_ptr<Tile>& tile);
+    void addBack(const T& value);
 
     /**
      * Remove an element from the front.
@@ -43,47 +146,79 @@ public:
     /**
      * Insert an element at a given index.
      *
-     * @param tile - a pointer to the tile to be inserted
-     * @param index - the index to insert the tile at
-     * @param replace - whether the tile should replace the existing tile
+     * @param value - the value to be inserted
+     * @param index - the index to insert the value at
+     * @param replace - whether the value should replace the existing value
      */
-    void insert(const shared_ptr<Tile>& tile, size_t index, bool replace);
+    void insert(const T& value, size_t index, bool replace);
 
     /**
-     * Remove an element with based on tile value.
+     * Remove the first element equal to the given value.
      *
-     * @param tile - the tile to be removed
+     * @param value - the value to be removed
      */
-    void remove(const shared_ptr<Tile>& tile);
+    void remove(const T& value);
 
     /**
      * Remove an element at a given index.
      *
-     * @param index - the index to remove the tile at
+     * @param index - the index to remove the value at
      * */
     void remove(size_t index);
 
+    /**
+     * Remove the element at the given position.
+     *
+     * @param position - an iterator to the element
+     * @return an iterator to the element after the removed one
+     */
+    iterator erase(iterator position);
+
     /**
      * Get the size of the linkedlist.
      *
      * @return an integer representing the count of elements
      */
-     size_t size() const;
+    size_t size() const;
 
     /**
-     * Get the element at a given index.
+     * Get the element at a given index, walks the list from the head so
+     * traversals should use iterators instead.
      *
-     * @param the index of the tile to get
-     * @return a pointer to the tile
+     * @param the index of the value to get
+     * @return the value
      */
-    shared_ptr<Tile> at(size_t index) const;
+    const T& at(size_t index) const;
 
     /**
-     * Query whether the given tile exists.
+     * Get the first element.
+     */
+    const T& front() const;
+
+    /**
+     * Get the last element.
+     */
+    const T& back() const;
+
+    /**
+     * Find the first element satisfying the predicate.
      *
-     * @param tile - the tile being checked
+     * @param predicate - a callable taking an element, returning bool
+     * @return an iterator to the element, end() if there is none
      */
-    bool contains(const Tile& tile) const;
+    template <class Predicate>
+    iterator findIf(Predicate predicate);
+
+    template <class Predicate>
+    const_iterator findIf(Predicate predicate) const;
+
+    /**
+     * Query whether any element satisfies the predicate.
+     *
+     * @param predicate - a callable taking an element, returning bool
+     */
+    template <class Predicate>
+    bool containsIf(Predicate predicate) const;
 
     /**
      * Query whether the LinkedList is empty.
@@ -92,18 +227,305 @@ public:
      */
     bool isEmpty() const;
 
+    iterator begin() { return iterator(head, this); }
+    iterator end() { return iterator(nullptr, this); }
+    const_iterator begin() const { return const_iterator(head, this); }
+    const_iterator end() const { return const_iterator(nullptr, this); }
+
+private:
     /**
-     * Overloaded output stream operator for easy printing.
-     *
-     * @param os - a reference to the output stream
-     * @param list - the LinkedList to be printed
+     * Take a node from the free list, or allocate one if it is empty.
      */
-    friend ostream& operator<<(ostream& os, const LinkedList& list);
+    Node<T>* acquireNode(const T& value);
 
-private:
+    /**
+     * Clear a node's value and return it to the free list.
+     */
+    void releaseNode(Node<T>* node);
+
+    /**
+     * Unlink a node from the list and release it.
+     */
+    void unlink(Node<T>* node);
+
+    /**
+     * Walk to the node at a given index.
+     */
+    Node<T>* nodeAt(size_t index) const;
+
+    ArenaAllocator<Node<T>> allocator;
     size_t length;
-    shared_ptr<Node> head;
-    shared_ptr<Node> tail;
+    Node<T>* head;
+    Node<T>* tail;
+    Node<T>* freeNodes;
+
+    friend class ListIterator<T, T>;
+    friend class ListIterator<T, const T>;
 };
 
+/**
+ * Print a list element, elements held by pointer are printed by value.
+ */
+template <class T>
+void printElement(ostream& os, const T& value) {
+    os << value;
+}
+
+template <class T>
+void printElement(ostream& os, const shared_ptr<T>& value) {
+    os << *value;
+}
+
+/**
+ * Overloaded output stream operator for easy printing.
+ *
+ * @param os - a reference to the output stream
+ * @param list - the LinkedList to be printed
+ */
+template <class T>
+ostream& operator<<(ostream& os, const LinkedList<T>& list) {
+    for (typename LinkedList<T>::const_iterator it = list.begin();
+         it != list.end(); ++it) {
+        if (it != list.begin())
+            os << ",";
+        printElement(os, *it);
+    }
+
+    return os;
+}
+
+template <class T>
+LinkedList<T>::LinkedList(const shared_ptr<Arena>& arena)
+    : allocator(arena), length(0), head(nullptr), tail(nullptr),
+      freeNodes(nullptr) {}
+
+template <class T>
+LinkedList<T>::LinkedList(const LinkedList& other)
+    : LinkedList(other, other.allocator.arena) {}
+
+template <class T>
+LinkedList<T>::LinkedList(const LinkedList& other,
+    const shared_ptr<Arena>& arena)
+    : LinkedList(arena) {
+    for (const T& value : other)
+        addBack(value);
+}
+
+template <class T>
+LinkedList<T>& LinkedList<T>::operator=(const LinkedList& other) {
+    if (this != &other) {
+        while (length != 0) removeFront();
+
+        for (const T& value : other)
+            addBack(value);
+    }
+
+    return *this;
+}
+
+template <class T>
+LinkedList<T>::~LinkedList() {
+    while (length != 0) removeFront();
+
+    while (freeNodes != nullptr) {
+        Node<T>* node = freeNodes;
+        freeNodes = freeNodes->next;
+        node->~Node<T>();
+        allocator.deallocate(node, 1);
+    }
+}
+
+template <class T>
+void LinkedList<T>::addFront(const T& value) {
+    Node<T>* toBeAdded = acquireNode(value);
+    if (length == 0) {
+        head = toBeAdded;
+        tail = toBeAdded;
+    } else {
+        head->previous = toBeAdded;
+        toBeAdded->next = head;
+        head = toBeAdded;
+    }
+
+    ++length;
+}
+
+template <class T>
+void LinkedList<T>::addBack(const T& value) {
+    Node<T>* toBeAdded = acquireNode(value);
+    if (length == 0) {
+        head = toBeAdded;
+        tail = toBeAdded;
+    } else {
+        tail->next = toBeAdded;
+        toBeAdded->previous = tail;
+        tail = toBeAdded;
+    }
+
+    ++length;
+}
+
+template <class T>
+void LinkedList<T>::removeFront() {
+    unlink(head);
+}
+
+template <class T>
+void LinkedList<T>::removeBack() {
+    unlink(tail);
+}
+
+template <class T>
+void LinkedList<T>::insert(const T& value, size_t index, bool replace) {
+    if (index >= length)
+        throw std::out_of_range("invalid index for LinkedList::insert");
+
+    Node<T>* nodeAtIndex = nodeAt(index);
+    if (replace) {
+        // the node is reused in place, so no links need to change
+        nodeAtIndex->value = value;
+    } else {
+        Node<T>* toBeInserted = acquireNode(value);
+        toBeInserted->next = nodeAtIndex;
+        toBeInserted->previous = nodeAtIndex->previous;
+        if (nodeAtIndex->previous != nullptr)
+            nodeAtIndex->previous->next = toBeInserted;
+        else
+            head = toBeInserted;
+        nodeAtIndex->previous = toBeInserted;
+
+        ++length;
+    }
+}
+
+template <class T>
+void LinkedList<T>::remove(const T& value) {
+    iterator position =
+        findIf([&value](const T& other) { return other == value; });
+    if (position != end())
+        erase(position);
+}
+
+template <class T>
+void LinkedList<T>::remove(size_t index) {
+    if (index >= length)
+        throw std::out_of_range("invalid index for LinkedList::remove");
+
+    unlink(nodeAt(index));
+}
+
+template <class T>
+typename LinkedList<T>::iterator LinkedList<T>::erase(iterator position) {
+    Node<T>* next = position.node->next;
+    unlink(position.node);
+
+    return iterator(next, this);
+}
+
+template <class T>
+size_t LinkedList<T>::size() const { return length; }
+
+template <class T>
+const T& LinkedList<T>::at(size_t index) const {
+    if (index >= length)
+        throw std::out_of_range("invalid index for LinkedList::at");
+
+    return nodeAt(index)->value;
+}
+
+template <class T>
+const T& LinkedList<T>::front() const {
+    if (length == 0)
+        throw std::out_of_range("empty list for LinkedList::front");
+
+    return head->value;
+}
+
+template <class T>
+const T& LinkedList<T>::back() const {
+    if (length == 0)
+        throw std::out_of_range("empty list for LinkedList::back");
+
+    return tail->value;
+}
+
+template <class T>
+template <class Predicate>
+typename LinkedList<T>::iterator LinkedList<T>::findIf(Predicate predicate) {
+    Node<T>* current = head;
+    while (current != nullptr && !predicate(current->value))
+        current = current->next;
+
+    return iterator(current, this);
+}
+
+template <class T>
+template <class Predicate>
+typename LinkedList<T>::const_iterator LinkedList<T>::findIf(
+    Predicate predicate) const {
+    Node<T>* current = head;
+    while (current != nullptr && !predicate(current->value))
+        current = current->next;
+
+    return const_iterator(current, this);
+}
+
+template <class T>
+template <class Predicate>
+bool LinkedList<T>::containsIf(Predicate predicate) const {
+    return findIf(predicate) != end();
+}
+
+template <class T>
+bool LinkedList<T>::isEmpty() const { return length == 0; }
+
+template <class T>
+Node<T>* LinkedList<T>::acquireNode(const T& value) {
+    Node<T>* node = freeNodes;
+    if (node != nullptr) {
+        freeNodes = node->next;
+        node->value = value;
+        node->next = nullptr;
+        node->previous = nullptr;
+    } else {
+        node = new (allocator.allocate(1)) Node<T>(value);
+    }
+
+    return node;
+}
+
+template <class T>
+void LinkedList<T>::releaseNode(Node<T>* node) {
+    // drop the value now so that a pooled node does not keep it alive
+    node->value = T();
+    node->previous = nullptr;
+    node->next = freeNodes;
+    freeNodes = node;
+}
+
+template <class T>
+void LinkedList<T>::unlink(Node<T>* node) {
+    if (node->previous != nullptr)
+        node->previous->next = node->next;
+    else
+        head = node->next;
+
+    if (node->next != nullptr)
+        node->next->previous = node->previous;
+    else
+        tail = node->previous;
+
+    releaseNode(node);
+    --length;
+}
+
+template <class T>
+Node<T>* LinkedList<T>::nodeAt(size_t index) const {
+    Node<T>* current = head;
+    for (size_t i = 0; i < index; ++i)
+        current = current->next;
+
+    return current;
+}
+
 #endif // ASSIGN2_LINKEDLIST_H
@@ -0,0 +1,270 @@
+#include "MoveSearch.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+using std::thread;
+
+template <class Rules>
+MoveSearch<Rules>::MoveSearch(const BasicGameSnapshot<Rules>& snapshot)
+    : index(snapshot.getBoard()->getIndex()), unseenTotal(0) {
+    shared_ptr<const BasicPlayer<Rules>> player = snapshot.getCurrentPlayer();
+    shared_ptr<const BasicPlayer<Rules>> opponent =
+        player == snapshot.getPlayer1()
+        ? snapshot.getPlayer2() : snapshot.getPlayer1();
+
+    hand.fill(0);
+    for (const shared_ptr<Tile>& tile : *player->getHand()->getTiles()) {
+        size_t kind = Rules::kindOf(*tile);
+        if (kind < Rules::KINDS)
+            ++hand[kind];
+    }
+
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind) {
+        unseen[kind] = player->getUnseen().count(kind);
+        unseenTotal += unseen[kind];
+    }
+    unseenKinds = maskOf(unseen);
+    opponentHandSize = opponent->getHand()->getTiles()->size();
+}
+
+template <class Rules>
+MoveSearch<Rules>::MoveSearch(
+    const LineIndex<Rules>& index, const KindCounts& hand)
+    : index(index), hand(hand), unseenTotal(0),
+      opponentHandSize(Rules::HAND_SIZE) {
+    unseen.fill(Rules::COPIES);
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind)
+        unseen[kind] -= hand[kind];
+    for (size_t cell = 0; cell < Rules::CELLS; ++cell) {
+        size_t kind = index.kindAt(
+            cell / Rules::BOARD_LENGTH, cell % Rules::BOARD_LENGTH);
+        if (kind != LineIndex<Rules>::NO_TILE)
+            --unseen[kind];
+    }
+
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind)
+        unseenTotal += unseen[kind];
+    unseenKinds = maskOf(unseen);
+}
+
+template <class Rules>
+SearchResult MoveSearch<Rules>::search(
+    Clock::duration budget, size_t count, size_t threads) const {
+    Clock::time_point start = Clock::now();
+    SearchResult result = {vector<Candidate>(), 0, 0, 0};
+
+    vector<Candidate> roots;
+    KindMask kinds = maskOf(hand);
+    for (size_t i = 0; i < cellCount(index); ++i) {
+        size_t cell = cellAt(index, i);
+        size_t row = cell / Rules::BOARD_LENGTH;
+        size_t column = cell % Rules::BOARD_LENGTH;
+        typename LineIndex<Rules>::Fit fit = index.fit(row, column, kinds);
+        KindMask accepted = fit.kinds;
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if ((accepted & 1) != 0)
+                roots.push_back({kind, row, column, fit.points, 0});
+        }
+    }
+
+    if (!roots.empty()) {
+        if (threads == 0)
+            threads = std::max<size_t>(thread::hardware_concurrency(), 1);
+        threads = std::min(threads, roots.size());
+
+        // the calling thread searches the first share of the roots itself
+        Worker worker = {index, hand, start + budget, 0, false};
+        vector<Worker> workers(threads, worker);
+        vector<array<double, MAX_DEPTH + 1>> values(roots.size());
+        vector<size_t> completed(threads, 0);
+        vector<thread> pool;
+        for (size_t t = 1; t < threads; ++t) {
+            pool.emplace_back(&MoveSearch::searchRoots, this,
+                std::ref(workers[t]), std::cref(roots), t, threads,
+                std::ref(values), std::ref(completed[t]));
+        }
+        searchRoots(workers[0], roots, 0, threads, values, completed[0]);
+        for (thread& worker : pool)
+            worker.join();
+
+        result.depth = *std::min_element(completed.begin(), completed.end());
+        for (size_t i = 0; i < roots.size(); ++i)
+            roots[i].expected = values[i][result.depth];
+        for (const Worker& worker : workers)
+            result.nodes += worker.nodes;
+
+        count = std::min(count, roots.size());
+        std::partial_sort(roots.begin(), roots.begin() + count, roots.end(),
+            [](const Candidate& a, const Candidate& b) {
+                return a.expected != b.expected
+                    ? a.expected > b.expected : a.points > b.points;
+            });
+        roots.resize(count);
+        result.candidates = roots;
+    }
+
+    result.milliseconds = std::chrono::duration<double, std::milli>(
+        Clock::now() - start).count();
+
+    return result;
+}
+
+template <class Rules>
+void MoveSearch<Rules>::searchRoots(Worker& worker,
+    const vector<Candidate>& roots, size_t first, size_t stride,
+    vector<array<double, MAX_DEPTH + 1>>& values, size_t& completed) const {
+    for (size_t depth = 1; depth <= MAX_DEPTH && !worker.stopped; ++depth) {
+        for (size_t i = first; i < roots.size() && !worker.stopped;
+             i += stride) {
+            const Candidate& root = roots[i];
+            values[i][depth] = placementValue(worker, root.kind,
+                root.row * Rules::BOARD_LENGTH + root.column, root.points,
+                true, depth);
+        }
+
+        // a depth cut short by the deadline is not counted
+        if (!worker.stopped)
+            completed = depth;
+    }
+}
+
+template <class Rules>
+double MoveSearch<Rules>::ownValue(Worker& worker, size_t depth) const {
+    double best = 0;
+    if (visit(worker))
+        return best;
+
+    KindMask kinds = maskOf(worker.hand);
+    for (size_t i = 0; i < cellCount(worker.index) && !worker.stopped; ++i) {
+        size_t cell = cellAt(worker.index, i);
+        typename LineIndex<Rules>::Fit fit = worker.index.fit(
+            cell / Rules::BOARD_LENGTH, cell % Rules::BOARD_LENGTH, kinds);
+        KindMask accepted = fit.kinds;
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if ((accepted & 1) != 0) {
+                best = std::max(best, placementValue(
+                    worker, kind, cell, fit.points, true, depth));
+            }
+        }
+    }
+
+    return best;
+}
+
+template <class Rules>
+double MoveSearch<Rules>::opponentValue(Worker& worker, size_t depth) const {
+    if (visit(worker))
+        return 0;
+
+    // the opponent would rather replace a tile than lose points by placing
+    array<double, Rules::KINDS> best;
+    best.fill(0);
+    for (size_t i = 0; i < cellCount(worker.index) && !worker.stopped; ++i) {
+        size_t cell = cellAt(worker.index, i);
+        typename LineIndex<Rules>::Fit fit = worker.index.fit(
+            cell / Rules::BOARD_LENGTH, cell % Rules::BOARD_LENGTH,
+            unseenKinds);
+        KindMask accepted = fit.kinds;
+        for (size_t kind = 0; accepted != 0; ++kind, accepted >>= 1) {
+            if ((accepted & 1) != 0) {
+                best[kind] = std::max(best[kind], placementValue(
+                    worker, kind, cell, fit.points, false, depth));
+            }
+        }
+    }
+
+    array<uint8_t, Rules::KINDS> order;
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind)
+        order[kind] = kind;
+    std::sort(order.begin(), order.end(), [&best](uint8_t a, uint8_t b) {
+        return best[a] > best[b];
+    });
+
+    /*
+     * the opponent plays their best kind held, so each kind's value counts
+     * for the chance that they hold it but none of the better kinds
+     */
+    double expected = 0;
+    double holdsBetter = 0;
+    size_t copies = 0;
+    for (size_t i = 0; i < Rules::KINDS && best[order[i]] > 0; ++i) {
+        copies += unseen[order[i]];
+        double holdsAny = 1 - probabilityOfNone(copies);
+        expected += best[order[i]] * (holdsAny - holdsBetter);
+        holdsBetter = holdsAny;
+    }
+
+    return expected;
+}
+
+template <class Rules>
+double MoveSearch<Rules>::placementValue(Worker& worker, size_t kind,
+    size_t cell, size_t points, bool own, size_t depth) const {
+    size_t row = cell / Rules::BOARD_LENGTH;
+    size_t column = cell % Rules::BOARD_LENGTH;
+    double value = points;
+
+    if (depth > 1) {
+        worker.index.push(kind, row, column);
+        if (own) {
+            --worker.hand[kind];
+            value -= opponentValue(worker, depth - 1);
+            ++worker.hand[kind];
+        } else {
+            value -= ownValue(worker, depth - 1);
+        }
+        worker.index.pop();
+    }
+
+    return value;
+}
+
+template <class Rules>
+bool MoveSearch<Rules>::visit(Worker& worker) {
+    // reading the clock every few nodes keeps its cost out of the search
+    if ((++worker.nodes & 63) == 0 && Clock::now() >= worker.deadline)
+        worker.stopped = true;
+
+    return worker.stopped;
+}
+
+template <class Rules>
+size_t MoveSearch<Rules>::cellCount(const LineIndex<Rules>& index) {
+    return index.getTileCount() == 0 ? 1 : index.getFrontierSize();
+}
+
+template <class Rules>
+size_t MoveSearch<Rules>::cellAt(const LineIndex<Rules>& index, size_t i) {
+    return index.getTileCount() == 0
+        ? (Rules::BOARD_LENGTH / 2) * (Rules::BOARD_LENGTH + 1)
+        : index.getFrontierCell(i);
+}
+
+template <class Rules>
+double MoveSearch<Rules>::probabilityOfNone(size_t copies) const {
+    double probability = 1;
+    size_t drawn = std::min(opponentHandSize, unseenTotal);
+    for (size_t i = 0; i < drawn && probability > 0; ++i) {
+        probability = unseenTotal < copies + i + 1 ? 0
+            : probability * (unseenTotal - copies - i) / (unseenTotal - i);
+    }
+
+    return probability;
+}
+
+template <class Rules>
+typename MoveSearch<Rules>::KindMask MoveSearch<Rules>::maskOf(
+    const KindCounts& counts) {
+    KindMask mask = 0;
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind) {
+        if (counts[kind] != 0)
+            mask |= KindMask(1) << kind;
+    }
+
+    return mask;
+}
+
+template class MoveSearch<StandardRules>;
+template class MoveSearch<ExtendedRules>;
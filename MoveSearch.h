@@ -0,0 +1,183 @@
+#ifndef MOVE_SEARCH_H
+#define MOVE_SEARCH_H
+
+#include "GameSnapshot.h"
+#include "LineIndex.h"
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+using std::array;
+using std::vector;
+
+/**
+ * A placement found by the search.
+ */
+struct Candidate {
+    size_t kind;
+    size_t row;
+    size_t column;
+
+    // the points the placement scores now
+    size_t points;
+
+    // the expected points ahead of the opponent at the searched depth
+    double expected;
+};
+
+/**
+ * The best placements found within a search's budget.
+ */
+struct SearchResult {
+    // the best candidates first, empty if no tile in hand can be placed
+    vector<Candidate> candidates;
+
+    // the number of plies every candidate was searched to
+    size_t depth;
+
+    size_t nodes;
+    double milliseconds;
+};
+
+/**
+ * @note
+ * Searches for the current player's best placement within a time budget.
+ * Each depth of an iterative deepening search alternates the player's own
+ * placements with the opponent's best reply. The opponent's hand is not
+ * known to the player, so a reply is valued over the tiles the player has
+ * not seen, weighting each kind's best reply by the chance the opponent
+ * holds it. Root placements are split across threads that play moves out
+ * on their own copy of the line index, and a depth only counts once every
+ * placement at it is done, so the search can be stopped at any point and
+ * still answer from the deepest complete depth. Draws to the player's own
+ * hand are not modelled.
+ */
+template <class Rules>
+class MoveSearch {
+public:
+    typedef typename LineTable<Rules>::KindMask KindMask;
+    typedef array<uint8_t, Rules::KINDS> KindCounts;
+    typedef std::chrono::steady_clock Clock;
+
+    // the deepest the search goes, even with time to spare
+    static constexpr size_t MAX_DEPTH = 8;
+
+    /**
+     * Construct a search from the current player's point of view.
+     *
+     * @param snapshot - the game to search
+     */
+    explicit MoveSearch(const BasicGameSnapshot<Rules>& snapshot);
+
+    /**
+     * Construct a search of a position with the bag full but for the hands,
+     * every tile neither on the board nor in the player's hand unseen.
+     *
+     * @param index - the line index of the board
+     * @param hand - the number of each kind in the player's hand
+     */
+    MoveSearch(const LineIndex<Rules>& index, const KindCounts& hand);
+
+    /**
+     * Search until the budget runs out or the search is exhausted. The
+     * first depth is always completed, it takes microseconds.
+     *
+     * @param budget - the time allowed
+     * @param count - the number of candidates to return
+     * @param threads - the number of threads, 0 for one per core
+     * @return the best candidates found
+     */
+    SearchResult search(Clock::duration budget, size_t count,
+        size_t threads = 0) const;
+
+private:
+    /**
+     * The state of one search thread.
+     */
+    struct Worker {
+        LineIndex<Rules> index;
+        KindCounts hand;
+        Clock::time_point deadline;
+        size_t nodes;
+        bool stopped;
+    };
+
+    /**
+     * Search the thread's share of the root placements, a depth at a time.
+     *
+     * @param worker - the thread's state
+     * @param roots - the placements the player can make
+     * @param first,stride - the root placements to search
+     * @param values - the value of each root placement at each depth
+     * @param completed - the deepest depth the thread has completed
+     */
+    void searchRoots(Worker& worker, const vector<Candidate>& roots,
+        size_t first, size_t stride,
+        vector<array<double, MAX_DEPTH + 1>>& values,
+        size_t& completed) const;
+
+    /**
+     * Get the value of the best placement for the player, 0 if they would
+     * rather replace a tile.
+     */
+    double ownValue(Worker& worker, size_t depth) const;
+
+    /**
+     * Get the expected value of the opponent's best reply over the tiles
+     * the player has not seen.
+     */
+    double opponentValue(Worker& worker, size_t depth) const;
+
+    /**
+     * Get the value of a placement, its points less the other player's
+     * value after it, searched to the given depth.
+     */
+    double placementValue(Worker& worker, size_t kind, size_t cell,
+        size_t points, bool own, size_t depth) const;
+
+    /**
+     * Count a node, stopping the worker once its deadline has passed.
+     *
+     * @return true if the worker has stopped
+     */
+    static bool visit(Worker& worker);
+
+    /**
+     * Get the number of cells a tile could be placed in, the frontier, or
+     * the centre of an empty board.
+     */
+    static size_t cellCount(const LineIndex<Rules>& index);
+
+    /**
+     * Get one of the cells a tile could be placed in.
+     *
+     * @param index - the line index
+     * @param i - between 0 and cellCount(index) - 1
+     * @return the cell as row * Rules::BOARD_LENGTH + column
+     */
+    static size_t cellAt(const LineIndex<Rules>& index, size_t i);
+
+    /**
+     * Get the probability that a hand drawn from the unseen tiles holds none
+     * of the given number of them.
+     */
+    double probabilityOfNone(size_t copies) const;
+
+    /**
+     * Get the mask of the kinds with a non-zero count.
+     */
+    static KindMask maskOf(const KindCounts& counts);
+
+    LineIndex<Rules> index;
+    KindCounts hand;
+    KindCounts unseen;
+    KindMask unseenKinds;
+    size_t unseenTotal;
+    size_t opponentHandSize;
+};
+
+template <class Rules>
+constexpr size_t MoveSearch<Rules>::MAX_DEPTH;
+
+#endif // !MOVE_SEARCH_H
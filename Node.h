@@ -1,42 +1,25 @@
-
 #ifndef ASSIGN2_NODE_H
 #define ASSIGN2_NODE_H
 
-#include "Tile.h"
-
-#include <memory>
-
-using std::shared_ptr;
-using std::make_shared;
-
+template <class T>
 class Node {
 public:
     /**
-     * Construct a node holding a pointer to a tile.
-     */
-    explicit Node(const shared_ptr<Tile>& tile);
-
-    /**
-     * Construct with reference to next and previous nodes besides the tile.
-     */
-    Node(
-        const shared_ptr<Tile>& tile,
-        const shared_ptr<Node>& next,
-        const shared_ptr<Node>& previous);
-
-    /**
-     * Destructor to free up the owning tile.
+     * Construct a node holding a value, unlinked from any list.
      */
-    ~Node();
+    explicit Node(const T& value)
+        : value(value), next(nullptr), previous(nullptr) {}
 
     /**
-     * Check for equality of two nodes based on the underlying tiles.
+     * Check for equality of two nodes based on the underlying values.
      */
-    friend bool operator==(const Node& node1, const Node& node2);
+    friend bool operator==(const Node& node1, const Node& node2) {
+        return node1.value == node2.value;
+    }
 
-    shared_ptr<Tile> tile;
-    shared_ptr<Node> next;
-    shared_ptr<Node> previous;
+    T value;
+    Node* next;
+    Node* previous;
 };
 
 #endif // ASSIGN2_NODE_H
@@ -0,0 +1,37 @@
+#include "Notation.h"
+#include "Constants.h"
+#include "Rules.h"
+
+#include <algorithm>
+#include <cctype>
+
+bool parseTile(const string& code, Colour& colour, Shape& shape) {
+    bool valid = code.size() == STRING_SIZE_2 && isdigit(code[1]);
+    if (valid) {
+        colour = code[0];
+        shape = code[1] - ASCII_NUMERICAL_BEGIN;
+        valid = StandardRules::kindOf(Tile(colour, shape)) <
+            StandardRules::KINDS;
+    }
+
+    return valid;
+}
+
+bool parsePosition(const string& code, size_t& row, size_t& column) {
+    bool valid = (code.size() == STRING_SIZE_2 ||
+                  code.size() == STRING_SIZE_3) &&
+        std::all_of(code.begin() + 1, code.end(), ::isdigit);
+    if (valid) {
+        row = code[0] - ASCII_ALPHABET_BEGIN;
+        column = std::stoul(code.substr(1));
+        valid = row < StandardRules::BOARD_LENGTH &&
+            column < StandardRules::BOARD_LENGTH;
+    }
+
+    return valid;
+}
+
+string formatPosition(size_t row, size_t column) {
+    return string(1, (char)(row + ASCII_ALPHABET_BEGIN)) +
+        std::to_string(column);
+}
@@ -0,0 +1,42 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "Tile.h"
+
+#include <string>
+
+using std::string;
+
+/**
+ * @note
+ * Reading and writing the tiles and grid locations of the standard game as
+ * players type them, such as R1 and A0. Codes are expected in upper case.
+ */
+
+/**
+ * Parse a tile such as R1.
+ *
+ * @param code - the tile
+ * @param colour,shape - set to the tile's attributes if it is valid
+ * @return true if the tile is in the standard game
+ */
+bool parseTile(const string& code, Colour& colour, Shape& shape);
+
+/**
+ * Parse a grid location such as A0 or Z25.
+ *
+ * @param code - the location
+ * @param row,column - set to the location if it is valid
+ * @return true if the location is on the board
+ */
+bool parsePosition(const string& code, size_t& row, size_t& column);
+
+/**
+ * Write a grid location such as A0.
+ *
+ * @param row,column - the location
+ * @return the location's code
+ */
+string formatPosition(size_t row, size_t column);
+
+#endif // !NOTATION_H
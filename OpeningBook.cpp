@@ -0,0 +1,527 @@
+#include "OpeningBook.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::lock_guard;
+using std::ofstream;
+using std::runtime_error;
+using std::thread;
+
+constexpr size_t OpeningBook::MAX_TILES;
+
+static const char FILE_MAGIC[8] = {'Q', 'W', 'K', 'B', 'O', 'O', 'K', 0};
+static const uint32_t VERSION = 1;
+
+static const size_t TYPES = StandardRules::TYPES;
+static const int CENTRE = StandardRules::BOARD_LENGTH / 2;
+
+// a cell that does not hold a tile of a shape, in that shape's column
+static const uint8_t ABSENT = UINT8_MAX;
+
+/*
+ * The canonical form of a position: the number of tiles on the board and
+ * their cells in order, then a column for each shape holding the hand's
+ * count of each colour and the colour of the shape's tile in each cell.
+ * The columns are sorted, so relabelling the shapes does not change it.
+ */
+static const size_t COLUMN_LENGTH = TYPES + OpeningBook::MAX_TILES;
+static const size_t CELLS_LENGTH = 1 + 2 * OpeningBook::MAX_TILES;
+typedef array<uint8_t, COLUMN_LENGTH> ShapeColumn;
+typedef array<uint8_t, CELLS_LENGTH + TYPES * COLUMN_LENGTH> Form;
+
+/**
+ * A tile on the board, its cell relative to the centre.
+ */
+struct Placed {
+    int row;
+    int column;
+    uint8_t colour;
+    uint8_t shape;
+};
+
+/**
+ * Rotate or reflect a cell relative to the centre.
+ */
+static void transformCell(uint8_t transform, int& row, int& column) {
+    if (transform & 1)
+        std::swap(row, column);
+    if (transform & 2)
+        row = -row;
+    if (transform & 4)
+        column = -column;
+}
+
+/**
+ * Undo transformCell.
+ */
+static void untransformCell(uint8_t transform, int& row, int& column) {
+    if (transform & 4)
+        column = -column;
+    if (transform & 2)
+        row = -row;
+    if (transform & 1)
+        std::swap(row, column);
+}
+
+/**
+ * Hash a canonical form, FNV-1a then the splitmix64 finaliser.
+ */
+static uint64_t hashOf(const Form& form) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (uint8_t byte : form)
+        hash = (hash ^ byte) * 0x100000001b3ULL;
+
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+/**
+ * Step to the next relabelling of the colours that keeps them in order of
+ * their signatures, permuting only the colours whose signatures tie. The
+ * colours on neither the board nor the hand are interchangeable, so they
+ * stay as they are.
+ *
+ * @param colourAt - the colour given each canonical label
+ * @param signatures - the signature of each colour
+ * @return false once every relabelling has been visited
+ */
+static bool nextRelabelling(array<uint8_t, TYPES>& colourAt,
+    const array<uint32_t, TYPES>& signatures) {
+    size_t end = TYPES;
+    while (end > 0) {
+        size_t begin = end - 1;
+        while (begin > 0 && signatures[colourAt[begin - 1]] ==
+               signatures[colourAt[end - 1]])
+            --begin;
+
+        if (signatures[colourAt[begin]] != 0 && std::next_permutation(
+                colourAt.begin() + begin, colourAt.begin() + end))
+            return true;
+        end = begin;
+    }
+
+    return false;
+}
+
+OpeningBook::OpeningBook(const string& fileName)
+    : data(nullptr), size(0), entries(nullptr), count(0), maxTiles(0) {
+    int file = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) < 0) {
+        if (file >= 0)
+            close(file);
+        throw runtime_error(fileName + ": " + strerror(errno));
+    }
+
+    size = status.st_size;
+    void* mapped = size > 0
+        ? mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED;
+    close(file);
+    if (mapped == MAP_FAILED)
+        throw runtime_error(fileName + ": cannot be mapped");
+    data = static_cast<const uint8_t*>(mapped);
+
+    FileHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, data, sizeof(header));
+        valid = memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+            header.version == VERSION && header.maxTiles <= MAX_TILES &&
+            size == sizeof(header) + header.entries * sizeof(Entry);
+    }
+
+    if (!valid) {
+        munmap(const_cast<uint8_t*>(data), size);
+        throw runtime_error(fileName + ": not an opening book");
+    }
+    entries = reinterpret_cast<const Entry*>(data + sizeof(header));
+    count = header.entries;
+    maxTiles = header.maxTiles;
+}
+
+OpeningBook::~OpeningBook() {
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+bool OpeningBook::lookup(const GameManager& game, BookMove& move) const {
+    return lookup(game.board->getIndex(), handOf(game), move);
+}
+
+bool OpeningBook::lookup(const LineIndex<StandardRules>& index,
+    const KindCounts& hand, BookMove& move) const {
+    uint64_t key;
+    Symmetry symmetry;
+    if (index.getTileCount() > maxTiles ||
+        !canonicalise(index, hand, key, symmetry))
+        return false;
+
+    const Entry* found = std::lower_bound(entries, entries + count, key,
+        [](const Entry& entry, uint64_t key) { return entry.key < key; });
+    if (found == entries + count || found->key != key ||
+        !fromCanonical(symmetry, *found, move.kind, move.row, move.column))
+        return false;
+    move.expected = found->expected;
+
+    // a key shared by another position would give a move that cannot be made
+    return hand[move.kind] > 0 &&
+        index.isLegal(move.kind, move.row, move.column);
+}
+
+size_t OpeningBook::getEntryCount() const { return count; }
+
+size_t OpeningBook::getMaxTiles() const { return maxTiles; }
+
+bool OpeningBook::canonicalise(const LineIndex<StandardRules>& index,
+    const KindCounts& hand, uint64_t& key, Symmetry& symmetry) {
+    size_t tiles = index.getTileCount();
+    if (tiles > MAX_TILES)
+        return false;
+
+    array<Placed, MAX_TILES> placed;
+    size_t found = 0;
+    for (size_t cell = 0; cell < StandardRules::CELLS && found < tiles;
+         ++cell) {
+        size_t row = cell / StandardRules::BOARD_LENGTH;
+        size_t column = cell % StandardRules::BOARD_LENGTH;
+        uint8_t kind = index.kindAt(row, column);
+        if (kind != LineIndex<StandardRules>::NO_TILE) {
+            placed[found++] = {int(row) - CENTRE, int(column) - CENTRE,
+                uint8_t(kind / TYPES), uint8_t(kind % TYPES)};
+        }
+    }
+
+    /*
+     * a colour's signature does not change under any symmetry, so only the
+     * relabellings that keep the signatures in order need to be tried
+     */
+    array<uint32_t, TYPES> signatures{};
+    for (size_t colour = 0; colour < TYPES; ++colour) {
+        for (size_t shape = 0; shape < TYPES; ++shape) {
+            uint32_t held = hand[colour * TYPES + shape];
+            signatures[colour] += held << (4 * held);
+        }
+    }
+    for (size_t i = 0; i < tiles; ++i)
+        signatures[placed[i].colour] += 1 << 16;
+
+    array<uint8_t, TYPES> ordered;
+    std::iota(ordered.begin(), ordered.end(), 0);
+    std::stable_sort(ordered.begin(), ordered.end(),
+        [&signatures](uint8_t a, uint8_t b) {
+            return signatures[a] < signatures[b];
+        });
+
+    // the board looks the same under every transform while it is empty
+    Form best;
+    bool haveBest = false;
+    array<array<Placed, MAX_TILES>, 8> seen;
+    size_t seenCount = 0;
+    for (uint8_t transform = 0; transform < (tiles == 0 ? 1 : 8);
+         ++transform) {
+        array<Placed, MAX_TILES> moved = placed;
+        int rowShift = 0;
+        int columnShift = 0;
+        for (size_t i = 0; i < tiles; ++i) {
+            transformCell(transform, moved[i].row, moved[i].column);
+            rowShift = i == 0 ? moved[i].row : std::min(rowShift,
+                moved[i].row);
+            columnShift = i == 0 ? moved[i].column : std::min(columnShift,
+                moved[i].column);
+        }
+        for (size_t i = 0; i < tiles; ++i) {
+            moved[i].row -= rowShift;
+            moved[i].column -= columnShift;
+        }
+        std::sort(moved.begin(), moved.begin() + tiles,
+            [](const Placed& a, const Placed& b) {
+                return a.row != b.row ? a.row < b.row : a.column < b.column;
+            });
+
+        Form form;
+        form.fill(0);
+        form[0] = tiles;
+        for (size_t i = 0; i < tiles; ++i) {
+            form[1 + 2 * i] = moved[i].row;
+            form[2 + 2 * i] = moved[i].column;
+        }
+
+        // a transform whose cells already come later cannot give the least
+        int order = haveBest ? memcmp(form.data(), best.data(),
+            CELLS_LENGTH) : -1;
+        if (order > 0)
+            continue;
+        if (order < 0)
+            haveBest = false;
+
+        // a transform that moves the tiles where another did gives its form
+        bool repeated = false;
+        for (size_t i = 0; i < seenCount && !repeated; ++i) {
+            repeated = std::equal(moved.begin(), moved.begin() + tiles,
+                seen[i].begin(), [](const Placed& a, const Placed& b) {
+                    return a.row == b.row && a.column == b.column &&
+                        a.colour == b.colour && a.shape == b.shape;
+                });
+        }
+        if (repeated)
+            continue;
+        seen[seenCount++] = moved;
+
+        // every colour relabelling, the shapes then sorted by their columns
+        array<uint8_t, TYPES> colourAt = ordered;
+        do {
+            array<uint8_t, TYPES> colours;
+            for (size_t colour = 0; colour < TYPES; ++colour)
+                colours[colourAt[colour]] = colour;
+
+            array<ShapeColumn, TYPES> columns;
+            for (size_t shape = 0; shape < TYPES; ++shape) {
+                for (size_t colour = 0; colour < TYPES; ++colour) {
+                    columns[shape][colour] =
+                        hand[colourAt[colour] * TYPES + shape];
+                }
+                for (size_t i = 0; i < MAX_TILES; ++i) {
+                    columns[shape][TYPES + i] =
+                        i < tiles && moved[i].shape == shape
+                        ? colours[moved[i].colour] : ABSENT;
+                }
+            }
+
+            array<uint8_t, TYPES> shapeAt;
+            std::iota(shapeAt.begin(), shapeAt.end(), 0);
+            std::sort(shapeAt.begin(), shapeAt.end(),
+                [&columns](uint8_t a, uint8_t b) {
+                    return columns[a] < columns[b];
+                });
+            for (size_t shape = 0; shape < TYPES; ++shape) {
+                std::copy(columns[shapeAt[shape]].begin(),
+                    columns[shapeAt[shape]].end(),
+                    form.begin() + CELLS_LENGTH + shape * COLUMN_LENGTH);
+            }
+
+            if (!haveBest || form < best) {
+                best = form;
+                haveBest = true;
+                symmetry.transform = transform;
+                symmetry.colours = colours;
+                for (size_t shape = 0; shape < TYPES; ++shape)
+                    symmetry.shapes[shapeAt[shape]] = shape;
+                symmetry.rowShift = rowShift;
+                symmetry.columnShift = columnShift;
+            }
+        } while (nextRelabelling(colourAt, signatures));
+    }
+
+    key = hashOf(best);
+    return true;
+}
+
+void OpeningBook::toCanonical(const Symmetry& symmetry, size_t kind,
+    size_t row, size_t column, Entry& entry) {
+    int canonicalRow = int(row) - CENTRE;
+    int canonicalColumn = int(column) - CENTRE;
+    transformCell(symmetry.transform, canonicalRow, canonicalColumn);
+
+    entry.kind = symmetry.colours[kind / TYPES] * TYPES +
+        symmetry.shapes[kind % TYPES];
+    entry.row = canonicalRow - symmetry.rowShift;
+    entry.column = canonicalColumn - symmetry.columnShift;
+}
+
+bool OpeningBook::fromCanonical(const Symmetry& symmetry, const Entry& entry,
+    size_t& kind, size_t& row, size_t& column) {
+    size_t colour = std::find(symmetry.colours.begin(),
+        symmetry.colours.end(), entry.kind / TYPES) - symmetry.colours.begin();
+    size_t shape = std::find(symmetry.shapes.begin(), symmetry.shapes.end(),
+        entry.kind % TYPES) - symmetry.shapes.begin();
+
+    int realRow = entry.row + symmetry.rowShift;
+    int realColumn = entry.column + symmetry.columnShift;
+    untransformCell(symmetry.transform, realRow, realColumn);
+    realRow += CENTRE;
+    realColumn += CENTRE;
+
+    kind = colour * TYPES + shape;
+    row = realRow;
+    column = realColumn;
+    return colour < TYPES && shape < TYPES &&
+        realRow >= 0 && realRow < int(StandardRules::BOARD_LENGTH) &&
+        realColumn >= 0 && realColumn < int(StandardRules::BOARD_LENGTH);
+}
+
+OpeningBook::KindCounts OpeningBook::handOf(const GameManager& game) {
+    KindCounts hand;
+    hand.fill(0);
+    for (const shared_ptr<Tile>& tile :
+         *game.currentPlayer->getHand()->getTiles()) {
+        size_t kind = StandardRules::kindOf(*tile);
+        if (kind < StandardRules::KINDS)
+            ++hand[kind];
+    }
+
+    return hand;
+}
+
+OpeningBookBuilder::OpeningBookBuilder(size_t maxTiles)
+    : maxTiles(std::min(maxTiles, OpeningBook::MAX_TILES)) {}
+
+void OpeningBookBuilder::add(const GameManager& game) {
+    if (game.board->getIndex().getTileCount() <= maxTiles)
+        add(game.board->getIndex(), OpeningBook::handOf(game));
+}
+
+void OpeningBookBuilder::addOpenings() {
+    /*
+     * every hand is a relabelling of one whose colour counts and shape
+     * counts both fall, so only those are enumerated and the rest left to
+     * their keys to merge
+     */
+    LineIndex<StandardRules> empty;
+    OpeningBook::KindCounts hand;
+    hand.fill(0);
+    array<size_t, TYPES> colours{};
+
+    vector<size_t> stack(1, 0);
+    size_t held = 0;
+    while (!stack.empty()) {
+        size_t& kind = stack.back();
+        if (held == StandardRules::HAND_SIZE) {
+            array<size_t, TYPES> shapes{};
+            for (size_t i = 0; i < StandardRules::KINDS; ++i)
+                shapes[i % TYPES] += hand[i];
+            if (std::is_sorted(shapes.rbegin(), shapes.rend()))
+                add(empty, hand);
+        }
+
+        /*
+         * take one more copy of this kind or a later one, or backtrack, the
+         * kinds of a colour all taken before the next colour's so that no
+         * colour is let hold more than the one before it
+         */
+        size_t colour = kind / TYPES;
+        if (held < StandardRules::HAND_SIZE && kind < StandardRules::KINDS) {
+            if (hand[kind] < StandardRules::COPIES &&
+                (colour == 0 || colours[colour] < colours[colour - 1])) {
+                ++hand[kind];
+                ++colours[colour];
+                ++held;
+                stack.push_back(kind);
+            } else {
+                ++kind;
+            }
+        } else {
+            stack.pop_back();
+            if (!stack.empty()) {
+                --hand[stack.back()];
+                --colours[stack.back() / TYPES];
+                --held;
+                ++stack.back();
+            }
+        }
+    }
+}
+
+size_t OpeningBookBuilder::getPositionCount() const {
+    lock_guard<mutex> guard(lock);
+    return positions.size();
+}
+
+void OpeningBookBuilder::write(const string& fileName,
+    MoveSearch<StandardRules>::Clock::duration budget, size_t threads) {
+    vector<const Position*> searched;
+    vector<OpeningBook::Entry> entries;
+    {
+        lock_guard<mutex> guard(lock);
+        for (const auto& position : positions) {
+            searched.push_back(&position.second);
+            entries.push_back(OpeningBook::Entry{position.first, 0, 0, 0, 0,
+                0});
+        }
+    }
+
+    // each thread takes the next position to search until none are left
+    std::atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < searched.size(); i = next++) {
+            LineIndex<StandardRules> index;
+            for (const array<uint8_t, 3>& tile : searched[i]->tiles)
+                index.place(tile[0], tile[1], tile[2]);
+
+            MoveSearch<StandardRules> search(index, searched[i]->hand);
+            SearchResult result = search.search(budget, 1, 1);
+            uint64_t key;
+            OpeningBook::Symmetry symmetry;
+            if (!result.candidates.empty() && OpeningBook::canonicalise(
+                    index, searched[i]->hand, key, symmetry)) {
+                const Candidate& best = result.candidates.front();
+                OpeningBook::toCanonical(symmetry, best.kind, best.row,
+                    best.column, entries[i]);
+                entries[i].expected = best.expected;
+                entries[i].depth = result.depth;
+            }
+        }
+    };
+
+    if (threads == 0)
+        threads = std::max<size_t>(thread::hardware_concurrency(), 1);
+    vector<thread> pool;
+    for (size_t t = 1; t < threads; ++t)
+        pool.emplace_back(work);
+    work();
+    for (thread& worker : pool)
+        worker.join();
+
+    // a position with no placement is left out, the map kept the keys sorted
+    entries.erase(std::remove_if(entries.begin(), entries.end(),
+        [](const OpeningBook::Entry& entry) { return entry.depth == 0; }),
+        entries.end());
+
+    OpeningBook::FileHeader header{};
+    memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.maxTiles = maxTiles;
+    header.entries = entries.size();
+
+    ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()),
+        entries.size() * sizeof(OpeningBook::Entry));
+    file.close();
+    if (!file)
+        throw runtime_error(fileName + ": cannot be written");
+}
+
+void OpeningBookBuilder::add(const LineIndex<StandardRules>& index,
+    const OpeningBook::KindCounts& hand) {
+    uint64_t key;
+    OpeningBook::Symmetry symmetry;
+    if (!OpeningBook::canonicalise(index, hand, key, symmetry))
+        return;
+
+    Position position;
+    position.hand = hand;
+    for (size_t cell = 0; cell < StandardRules::CELLS; ++cell) {
+        size_t row = cell / StandardRules::BOARD_LENGTH;
+        size_t column = cell % StandardRules::BOARD_LENGTH;
+        uint8_t kind = index.kindAt(row, column);
+        if (kind != LineIndex<StandardRules>::NO_TILE) {
+            position.tiles.push_back(
+                {kind, uint8_t(row), uint8_t(column)});
+        }
+    }
+
+    lock_guard<mutex> guard(lock);
+    positions.emplace(key, position);
+}
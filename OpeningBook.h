@@ -0,0 +1,238 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include "GameManager.h"
+#include "MoveSearch.h"
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::array;
+using std::map;
+using std::mutex;
+using std::string;
+using std::vector;
+
+/**
+ * A placement taken from the book, on the board it was looked up for.
+ */
+struct BookMove {
+    size_t kind;
+    size_t row;
+    size_t column;
+
+    // the expected points ahead of the opponent the search found
+    double expected;
+};
+
+/**
+ * @note
+ * Best first placements of the standard game, searched offline and stored
+ * as a table sorted by a key of the position, which the book maps read-only
+ * into memory and binary searches in place, so opening it parses nothing
+ * and every process using the same file shares its pages.
+ *
+ * A position is the board while it has few tiles and the mover's hand,
+ * which decide the rest: the unseen tiles are whatever is left, and the
+ * opponent's hand is full. Positions that only differ by relabelling the
+ * colours or the shapes, or by rotating, reflecting or moving the tiles on
+ * the board, have the same key, and their moves are stored in the frame of
+ * the position all of them map to.
+ */
+class OpeningBook {
+public:
+    typedef MoveSearch<StandardRules>::KindCounts KindCounts;
+
+    // the most tiles on the board of a position in a book
+    static constexpr size_t MAX_TILES = 6;
+
+    /**
+     * A move as stored, in the frame of the canonical position.
+     */
+    struct Entry {
+        uint64_t key;
+        float expected;
+        uint8_t kind;
+        int8_t row;
+        int8_t column;
+        uint8_t depth;
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t maxTiles;
+        uint64_t entries;
+        uint8_t reserved[40];
+    };
+
+    static_assert(sizeof(Entry) == 16, "an entry must be 16 bytes");
+    static_assert(sizeof(FileHeader) == 64, "file header must be 64 bytes");
+
+    /**
+     * The relabelling and movement that takes a position to its canonical
+     * one.
+     */
+    struct Symmetry {
+        // a rotation or reflection of the board about its centre, 0 to 7
+        uint8_t transform;
+
+        // the canonical label of each colour and shape
+        array<uint8_t, StandardRules::TYPES> colours;
+        array<uint8_t, StandardRules::TYPES> shapes;
+
+        // the offset of the canonical origin after the transform
+        int rowShift;
+        int columnShift;
+    };
+
+    /**
+     * Map a book file.
+     *
+     * @param fileName - the name of the file
+     * @throws runtime_error if the file cannot be mapped or is not valid
+     */
+    explicit OpeningBook(const string& fileName);
+
+    /**
+     * Destructor to unmap the file.
+     */
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    /**
+     * Look up the current player's best placement.
+     *
+     * @param game - the game
+     * @param move - set to the placement found
+     * @return false if the position is not in the book
+     */
+    bool lookup(const GameManager& game, BookMove& move) const;
+
+    /**
+     * Look up the best placement of a hand.
+     *
+     * @param index - the line index of the board
+     * @param hand - the number of each kind in the hand
+     * @param move - set to the placement found
+     * @return false if the position is not in the book
+     */
+    bool lookup(const LineIndex<StandardRules>& index,
+        const KindCounts& hand, BookMove& move) const;
+
+    /**
+     * Get the number of positions in the book.
+     */
+    size_t getEntryCount() const;
+
+    /**
+     * Get the most tiles on the board of a position in the book.
+     */
+    size_t getMaxTiles() const;
+
+    /**
+     * Get the key of a position.
+     *
+     * @param index - the line index of the board
+     * @param hand - the number of each kind in the hand
+     * @param symmetry - set to the mapping to the canonical position
+     * @return false if the board has more than MAX_TILES tiles
+     */
+    static bool canonicalise(const LineIndex<StandardRules>& index,
+        const KindCounts& hand, uint64_t& key, Symmetry& symmetry);
+
+    /**
+     * Store a placement in the frame of the canonical position.
+     */
+    static void toCanonical(const Symmetry& symmetry, size_t kind,
+        size_t row, size_t column, Entry& entry);
+
+    /**
+     * Take a stored placement back to the frame of the position.
+     *
+     * @return false if the placement falls off the board
+     */
+    static bool fromCanonical(const Symmetry& symmetry, const Entry& entry,
+        size_t& kind, size_t& row, size_t& column);
+
+    /**
+     * Get the number of each kind in the current player's hand.
+     */
+    static KindCounts handOf(const GameManager& game);
+
+private:
+    const uint8_t* data;
+    size_t size;
+    const Entry* entries;
+    size_t count;
+    size_t maxTiles;
+};
+
+/**
+ * @note
+ * Collects positions from any number of threads, then searches each of
+ * them and writes the book, its entries sorted by key.
+ */
+class OpeningBookBuilder {
+public:
+    /**
+     * @param maxTiles - the most tiles on the board of a position to keep
+     */
+    explicit OpeningBookBuilder(size_t maxTiles);
+
+    /**
+     * Add the current player's position, unless the board has too many
+     * tiles or the position is already in.
+     *
+     * @param game - the game
+     */
+    void add(const GameManager& game);
+
+    /**
+     * Add every hand that can be dealt, on an empty board.
+     */
+    void addOpenings();
+
+    /**
+     * Get the number of distinct positions added.
+     */
+    size_t getPositionCount() const;
+
+    /**
+     * Search every position and write the book.
+     *
+     * @param fileName - the name of the file
+     * @param budget - the time allowed for each position
+     * @param threads - the number of threads, 0 for one per core
+     * @throws runtime_error if the file cannot be written
+     */
+    void write(const string& fileName,
+        MoveSearch<StandardRules>::Clock::duration budget, size_t threads);
+
+private:
+    /**
+     * The tiles on the board, as kind, row and column, and the hand.
+     */
+    struct Position {
+        vector<array<uint8_t, 3>> tiles;
+        OpeningBook::KindCounts hand;
+    };
+
+    /**
+     * Add a position under its key unless it is already in.
+     */
+    void add(const LineIndex<StandardRules>& index,
+        const OpeningBook::KindCounts& hand);
+
+    const size_t maxTiles;
+    map<uint64_t, Position> positions;
+    mutable mutex lock;
+};
+
+#endif // !OPENING_BOOK_H
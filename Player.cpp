@@ -1,21 +1,69 @@
 
 #include "Player.h"
 
-Player::Player(const string& name, shared_ptr<PlayerHand> hand)
+template <class Rules>
+BasicPlayer<Rules>::BasicPlayer(
+    const string& name, shared_ptr<BasicPlayerHand<Rules>> hand)
     : name(name), score(0), hand(hand) {}
 
-Player::~Player() { hand.reset(); }
+template <class Rules>
+BasicPlayer<Rules>::BasicPlayer(const BasicPlayer& player)
+    : BasicPlayer(player, player.hand->getArena()) {}
 
-string Player::getName() { return name; }
+template <class Rules>
+BasicPlayer<Rules>::BasicPlayer(const BasicPlayer& player,
+    const shared_ptr<Arena>& arena)
+    : name(player.name), score(player.score),
+      hand(allocate_shared<BasicPlayerHand<Rules>>(
+          ArenaAllocator<BasicPlayerHand<Rules>>(arena), *player.hand,
+          arena)),
+      unseen(player.unseen) {}
 
-void Player::setName(const string& name) { this->name = name; }
+template <class Rules>
+BasicPlayer<Rules>::~BasicPlayer() { hand.reset(); }
 
-size_t Player::getScore() { return score; }
+template <class Rules>
+string BasicPlayer<Rules>::getName() const { return name; }
 
-void Player::setScore(size_t score) { this->score = score; }
+template <class Rules>
+void BasicPlayer<Rules>::setName(const string& name) { this->name = name; }
 
-shared_ptr<PlayerHand> Player::getHand() { return hand; }
+template <class Rules>
+size_t BasicPlayer<Rules>::getScore() const { return score; }
 
-bool operator==(const Player& player1, const Player& player2) {
+template <class Rules>
+void BasicPlayer<Rules>::setScore(size_t score) { this->score = score; }
+
+template <class Rules>
+shared_ptr<BasicPlayerHand<Rules>> BasicPlayer<Rules>::getHand() {
+    return hand;
+}
+
+template <class Rules>
+shared_ptr<const BasicPlayerHand<Rules>> BasicPlayer<Rules>::getHand() const {
+    return hand;
+}
+
+template <class Rules>
+BasicUnseenTiles<Rules>& BasicPlayer<Rules>::getUnseen() {
+    return unseen;
+}
+
+template <class Rules>
+const BasicUnseenTiles<Rules>& BasicPlayer<Rules>::getUnseen() const {
+    return unseen;
+}
+
+template <class Rules>
+bool operator==(
+    const BasicPlayer<Rules>& player1, const BasicPlayer<Rules>& player2) {
     return player1.name == player2.name;
 }
+
+template class BasicPlayer<StandardRules>;
+template bool operator==(
+    const BasicPlayer<StandardRules>&, const BasicPlayer<StandardRules>&);
+
+template class BasicPlayer<ExtendedRules>;
+template bool operator==(
+    const BasicPlayer<ExtendedRules>&, const BasicPlayer<ExtendedRules>&);
@@ -3,31 +3,51 @@
 #define PLAYER_H
 
 #include "PlayerHand.h"
+#include "UnseenTiles.h"
 
 #include <string>
 
 using std::string;
 
-class Player {
+template <class Rules>
+class BasicPlayer;
+
+template <class Rules>
+bool operator==(
+    const BasicPlayer<Rules>& player1, const BasicPlayer<Rules>& player2);
+
+template <class Rules>
+class BasicPlayer {
 public:
     /**
      * Construct a player with name and initial hand.
      *
      * @param name - the name
      * @param hand - the PlayerHand*/
-    Player(const string& name, shared_ptr<PlayerHand> hand);
+    BasicPlayer(const string& name, shared_ptr<BasicPlayerHand<Rules>> hand);
+
+    /**
+     * Copy constructor, copies the hand so the players are independent.
+     */
+    BasicPlayer(const BasicPlayer& player);
+
+    /**
+     * Copy a player, with a hand allocated from the given arena or the heap
+     * if there is none.
+     */
+    BasicPlayer(const BasicPlayer& player, const shared_ptr<Arena>& arena);
 
     /**
      * Destructor to free up the player's hand.
      */
-    ~Player();
+    ~BasicPlayer();
 
     /**
      * Get the player's name.
      *
      * @return the name
      */
-    string getName();
+    string getName() const;
 
     /**
      * Set the name of the player.
@@ -41,7 +61,7 @@ public:
      *
      * @return the integer representing score
      */
-    size_t getScore();
+    size_t getScore() const;
 
     /**
      * Set the player's score.
@@ -55,7 +75,28 @@ public:
      *
      * @return a pointer to the PlayerHand
      */
-    shared_ptr<PlayerHand> getHand();
+    shared_ptr<BasicPlayerHand<Rules>> getHand();
+
+    /**
+     * Get the player's hand as read-only.
+     *
+     * @return a pointer to the const PlayerHand
+     */
+    shared_ptr<const BasicPlayerHand<Rules>> getHand() const;
+
+    /**
+     * Get the tiles not yet seen by the player.
+     *
+     * @return a reference to the tracker
+     */
+    BasicUnseenTiles<Rules>& getUnseen();
+
+    /**
+     * Get the tiles not yet seen by the player as read-only.
+     *
+     * @return a reference to the const tracker
+     */
+    const BasicUnseenTiles<Rules>& getUnseen() const;
 
     /**
      * Overloaded equality operator for comparing equality between two players.
@@ -63,12 +104,16 @@ public:
      * @param player1,player2 - the players to compare
      * @return true if the player's have the same name
      */
-    friend bool operator==(const Player& player1, const Player& player2);
+    friend bool operator== <>(
+        const BasicPlayer& player1, const BasicPlayer& player2);
 
 private:
     string name;
     size_t score;
-    shared_ptr<PlayerHand> hand;
+    shared_ptr<BasicPlayerHand<Rules>> hand;
+    BasicUnseenTiles<Rules> unseen;
 };
 
+typedef BasicPlayer<StandardRules> Player;
+
 #endif // !PLAYER_H
@@ -3,17 +3,35 @@
 
 using std::invalid_argument;
 
-PlayerHand::PlayerHand() : tiles(make_shared<LinkedList>()) {}
-
-PlayerHand::PlayerHand(const shared_ptr<LinkedList>& tiles) : tiles(tiles) {}
-
-PlayerHand::PlayerHand(const PlayerHand& hand) : tiles(hand.tiles) {}
-
-PlayerHand::~PlayerHand() { tiles.reset(); }
-
-void PlayerHand::addTile(shared_ptr<Tile> tile) { tiles->addBack(tile); }
+template <class Rules>
+BasicPlayerHand<Rules>::BasicPlayerHand(const shared_ptr<Arena>& arena)
+    : arena(arena), tiles(allocate_shared<TileList>(
+        ArenaAllocator<TileList>(arena), arena)) {}
+
+template <class Rules>
+BasicPlayerHand<Rules>::BasicPlayerHand(const shared_ptr<TileList>& tiles)
+    : arena(nullptr), tiles(tiles) {}
+
+template <class Rules>
+BasicPlayerHand<Rules>::BasicPlayerHand(const BasicPlayerHand& hand)
+    : BasicPlayerHand(hand, hand.arena) {}
+
+template <class Rules>
+BasicPlayerHand<Rules>::BasicPlayerHand(const BasicPlayerHand& hand,
+    const shared_ptr<Arena>& arena)
+    : arena(arena), tiles(allocate_shared<TileList>(
+        ArenaAllocator<TileList>(arena), *hand.tiles, arena)) {}
+
+template <class Rules>
+BasicPlayerHand<Rules>::~BasicPlayerHand() { tiles.reset(); }
+
+template <class Rules>
+void BasicPlayerHand<Rules>::addTile(shared_ptr<Tile> tile) {
+    tiles->addBack(tile);
+}
 
-shared_ptr<Tile> PlayerHand::playTile(const Tile& tile) {
+template <class Rules>
+shared_ptr<Tile> BasicPlayerHand<Rules>::playTile(const Tile& tile) {
     shared_ptr<Tile> toPlay = nullptr;
 
     try {
@@ -26,39 +44,72 @@ shared_ptr<Tile> PlayerHand::playTile(const Tile& tile) {
     return toPlay;
 }
 
-void PlayerHand::replaceTile(const Tile& tile, TileBag& bag) {
+template <class Rules>
+shared_ptr<Tile> BasicPlayerHand<Rules>::replaceTile(
+    const Tile& tile, BasicTileBag<Rules>& bag) {
+    shared_ptr<Tile> fromBag = nullptr;
+
     try {
         shared_ptr<Tile> fromHand = getTile(tile);
-        shared_ptr<Tile> fromBag = bag.replace(fromHand);
+        fromBag = bag.replace(fromHand);
         tiles->remove(fromHand);
         tiles->addBack(fromBag);
     } catch (invalid_argument& exception) {
         throw invalid_argument("invalid tile for PlayerHand::replaceTile");
     }
+
+    return fromBag;
 }
 
-shared_ptr<Tile> PlayerHand::getTile(const Tile& tile) {
-    bool found = false;
-    shared_ptr<Tile> currentTile = nullptr;
-    shared_ptr<Tile> toReturn = nullptr;
-
-    for (unsigned int i = 0; i < tiles->size() && !found; ++i) {
-        currentTile = tiles->at(i);
-        if (tile == *currentTile) {
-            toReturn = currentTile;
-            found = true;
-        }
-    }
+template <class Rules>
+shared_ptr<Tile> BasicPlayerHand<Rules>::getTile(const Tile& tile) {
+    TileList::iterator found = tiles->findIf(
+        [&tile](const shared_ptr<Tile>& other) { return tile == *other; });
 
-    if (!found)
+    if (found == tiles->end())
         throw invalid_argument("invalid tile for PlayerHand::getTile");
 
-    return toReturn;
+    return *found;
 }
 
-shared_ptr<LinkedList> PlayerHand::getTiles() { return tiles; }
+template <class Rules>
+bool BasicPlayerHand<Rules>::hasTile(const Tile& tile) const {
+    return tiles->containsIf(
+        [&tile](const shared_ptr<Tile>& other) { return tile == *other; });
+}
 
-ostream& operator<<(ostream& os, const PlayerHand& hand) {
+template <class Rules>
+typename LineTable<Rules>::KindMask
+BasicPlayerHand<Rules>::getKindMask() const {
+    typename LineTable<Rules>::KindMask kinds = 0;
+    for (const shared_ptr<Tile>& tile : *tiles) {
+        size_t kind = Rules::kindOf(*tile);
+        if (kind < Rules::KINDS)
+            kinds |= typename LineTable<Rules>::KindMask(1) << kind;
+    }
+
+    return kinds;
+}
+
+template <class Rules>
+shared_ptr<TileList> BasicPlayerHand<Rules>::getTiles() { return tiles; }
+
+template <class Rules>
+shared_ptr<const TileList> BasicPlayerHand<Rules>::getTiles() const {
+    return tiles;
+}
+
+template <class Rules>
+shared_ptr<Arena> BasicPlayerHand<Rules>::getArena() const { return arena; }
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicPlayerHand<Rules>& hand) {
     os << *hand.tiles;
     return os;
 }
+
+template class BasicPlayerHand<StandardRules>;
+template ostream& operator<<(ostream&, const BasicPlayerHand<StandardRules>&);
+
+template class BasicPlayerHand<ExtendedRules>;
+template ostream& operator<<(ostream&, const BasicPlayerHand<ExtendedRules>&);
@@ -3,28 +3,41 @@
 #define PLAYER_HAND_H
 
 #include "TileBag.h"
+#include "LineTable.h"
 
-class PlayerHand {
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicPlayerHand<Rules>& hand);
+
+template <class Rules>
+class BasicPlayerHand {
 public:
     /**
-     * Construct a hand with an empty LinkedList.
+     * Construct a hand with an empty LinkedList, the nodes are allocated from
+     * the given arena or the heap if there is none.
      */
-    PlayerHand();
+    explicit BasicPlayerHand(const shared_ptr<Arena>& arena = nullptr);
 
     /**
      * Construct a hand with a LinkedList of tiles.
      */
-    PlayerHand(const shared_ptr<LinkedList>& tiles);
+    BasicPlayerHand(const shared_ptr<TileList>& tiles);
+
+    /**
+     * Copy constructor, copies the list of tiles so the hands are independent.
+     */
+    BasicPlayerHand(const BasicPlayerHand& hand);
 
     /**
-     * Copy constructor.
+     * Copy a hand into one whose nodes are allocated from the given arena, or
+     * the heap if there is none.
      */
-    PlayerHand(const PlayerHand& hand);
+    BasicPlayerHand(const BasicPlayerHand& hand,
+        const shared_ptr<Arena>& arena);
 
     /**
      * Destructor to free the tiles in the hand.
      */
-    ~PlayerHand();
+    ~BasicPlayerHand();
 
     /**
      * Add a tile to the end of the hand.
@@ -46,8 +59,9 @@ public:
      *
      * @param tile - the tile to be replaced
      * @param bag - the bag to replaced the tile from
+     * @return a pointer to the tile drawn from the bag
      */
-    void replaceTile(const Tile& tile, TileBag& bag);
+    shared_ptr<Tile> replaceTile(const Tile& tile, BasicTileBag<Rules>& bag);
 
     /**
      * Get a tile of the given value.
@@ -57,12 +71,41 @@ public:
      */
     shared_ptr<Tile> getTile(const Tile& tile);
 
+    /**
+     * Query whether a tile of the given value is in the hand.
+     *
+     * @param tile - the tile
+     * @return true if the hand holds the tile
+     */
+    bool hasTile(const Tile& tile) const;
+
+    /**
+     * Get the kinds of tile in the hand.
+     *
+     * @return a mask with a bit set for each kind held
+     */
+    typename LineTable<Rules>::KindMask getKindMask() const;
+
     /**
      * Get all the tiles from the hand.
      *
      * @return a pointer to the tile
      */
-    shared_ptr<LinkedList> getTiles();
+    shared_ptr<TileList> getTiles();
+
+    /**
+     * Get all the tiles from the hand as read-only.
+     *
+     * @return a pointer to the tiles
+     */
+    shared_ptr<const TileList> getTiles() const;
+
+    /**
+     * Get the arena the hand allocates from.
+     *
+     * @return a pointer to the arena, nullptr if allocating from the heap
+     */
+    shared_ptr<Arena> getArena() const;
 
     /**
      * Overloaded output stream operator for easy printing.
@@ -70,10 +113,13 @@ public:
      * @param os - a reference to the output stream
      * @param hand - a reference to the PlayerHand to be printed
      */
-    friend ostream& operator<<(ostream& os, const PlayerHand& hand);
+    friend ostream& operator<< <>(ostream& os, const BasicPlayerHand& hand);
 
 private:
-    shared_ptr<LinkedList> tiles;
+    shared_ptr<Arena> arena;
+    shared_ptr<TileList> tiles;
 };
 
+typedef BasicPlayerHand<StandardRules> PlayerHand;
+
 #endif // !PLAYER_HAND_H
@@ -0,0 +1,83 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "TileCodes.h"
+
+#include <cstddef>
+
+/**
+ * @note
+ * A rule set is the policy the board, bag, hand and game manager templates
+ * are parameterised on. Every size is a compile-time constant, so the loops
+ * and arrays of each specialisation have fixed bounds. The tile set has as
+ * many shapes as colours, which is also the length of a QWIRKLE.
+ *
+ * @param Types - the number of colours, and of shapes
+ * @param Copies - the number of copies of each tile
+ * @param HandSize - the number of tiles in a hand
+ * @param BoardLength - the number of rows, and of columns
+ */
+template <size_t Types, size_t Copies, size_t HandSize, size_t BoardLength>
+struct RuleSet {
+    static_assert(Types >= 2 && Types <= MAX_TILE_TYPES,
+        "a rule set needs between 2 and MAX_TILE_TYPES colours and shapes");
+
+    static constexpr size_t TYPES = Types;
+    static constexpr size_t COPIES = Copies;
+    static constexpr size_t HAND_SIZE = HandSize;
+    static constexpr size_t BOARD_LENGTH = BoardLength;
+    static constexpr size_t CELLS = BoardLength * BoardLength;
+    static constexpr size_t KINDS = Types * Types;
+    static constexpr size_t TILES = KINDS * Copies;
+    static constexpr size_t MAX_LINE_SIZE = Types;
+    static constexpr size_t SCORE_BONUS = Types;
+
+    /**
+     * Get the colour with the given index.
+     */
+    static Colour colourAt(size_t index) { return COLOUR_CODES[index]; }
+
+    /**
+     * Get the shape with the given index.
+     */
+    static Shape shapeAt(size_t index) { return SHAPE_CODES[index]; }
+
+    /**
+     * Get the index of a tile's colour and shape combination.
+     *
+     * @return the kind between 0 and KINDS - 1, KINDS if the tile is not part
+     * of this rule set
+     */
+    static size_t kindOf(const Tile& tile) {
+        return tile.getColourIndex() < Types && tile.getShapeIndex() < Types
+            ? tile.getColourIndex() * Types + tile.getShapeIndex()
+            : KINDS;
+    }
+};
+
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::TYPES;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::COPIES;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::HAND_SIZE;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::BOARD_LENGTH;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::CELLS;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::KINDS;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::TILES;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::MAX_LINE_SIZE;
+template <size_t T, size_t C, size_t H, size_t B>
+constexpr size_t RuleSet<T, C, H, B>::SCORE_BONUS;
+
+// the standard game: 6 colours x 6 shapes x 2 copies, 6 tiles a hand
+typedef RuleSet<6, 2, 6, 26> StandardRules;
+
+// a larger variant: 8 colours x 8 shapes x 3 copies
+typedef RuleSet<8, 3, 6, 26> ExtendedRules;
+
+#endif // !RULES_H
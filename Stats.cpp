@@ -0,0 +1,142 @@
+#include "Stats.h"
+
+#include <iomanip>
+
+using std::endl;
+using std::fixed;
+using std::left;
+using std::memory_order_relaxed;
+using std::right;
+using std::setprecision;
+using std::setw;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+static const char* TIMER_NAMES[TIMER_COUNT] = {
+    "parse", "validate", "score", "render", "save", "autosave", "load"};
+
+static const char* COUNTER_NAMES[COUNTER_COUNT] = {"moves accepted",
+    "rejected: not in hand", "rejected: occupied", "rejected: no adjacent",
+    "rejected: line rules", "replaces accepted", "replaces rejected",
+    "qwirkles"};
+
+bool Stats::dumpOnExit = false;
+array<LatencyHistogram, TIMER_COUNT> Stats::timers;
+array<atomic<uint64_t>, COUNTER_COUNT> Stats::counters;
+
+LatencyHistogram::LatencyHistogram() : total(0), highest(0) {
+    for (atomic<uint64_t>& bucket : buckets)
+        bucket.store(0, memory_order_relaxed);
+}
+
+void LatencyHistogram::record(uint64_t nanoseconds) {
+    buckets[bucketOf(nanoseconds)].fetch_add(1, memory_order_relaxed);
+    total.fetch_add(1, memory_order_relaxed);
+
+    uint64_t current = highest.load(memory_order_relaxed);
+    while (nanoseconds > current &&
+        !highest.compare_exchange_weak(current, nanoseconds,
+            memory_order_relaxed)) {}
+}
+
+uint64_t LatencyHistogram::count() const {
+    return total.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::max() const {
+    return highest.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::percentile(double fraction) const {
+    uint64_t target = static_cast<uint64_t>(fraction * count() + 0.5);
+    if (target == 0)
+        target = 1;
+
+    uint64_t seen = 0;
+    size_t bucket = 0;
+    while (bucket < BUCKETS - 1 &&
+        (seen += buckets[bucket].load(memory_order_relaxed)) < target)
+        ++bucket;
+
+    // the bucket's upper bound may overshoot the largest value recorded
+    uint64_t value = highestIn(bucket);
+    return value < max() ? value : max();
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t nanoseconds) {
+    if (nanoseconds < LINEAR_BUCKETS)
+        return nanoseconds;
+
+    // magnitude from the highest set bit, then the next 3 bits below it
+    size_t magnitude = 63 - __builtin_clzll(nanoseconds);
+    size_t shift = magnitude - 3;
+    size_t top = (nanoseconds >> shift) - SUB_BUCKETS;
+
+    return LINEAR_BUCKETS + (magnitude - 4) * SUB_BUCKETS + top;
+}
+
+uint64_t LatencyHistogram::highestIn(size_t bucket) {
+    if (bucket < LINEAR_BUCKETS)
+        return bucket;
+
+    size_t magnitude = (bucket - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+    uint64_t top = (bucket - LINEAR_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+
+    return ((top + 1) << (magnitude - 3)) - 1;
+}
+
+void Stats::record(Timer timer, uint64_t nanoseconds) {
+    timers[timer].record(nanoseconds);
+}
+
+void Stats::count(Counter counter) {
+    counters[counter].fetch_add(1, memory_order_relaxed);
+}
+
+void Stats::print(ostream& os) {
+    if (!enabled()) {
+        os << "Statistics are not compiled in, rebuild with make STATS=1."
+           << endl;
+        return;
+    }
+
+    os << left << setw(12) << "timer" << right << setw(8) << "count"
+       << setw(12) << "p50 (us)" << setw(12) << "p99 (us)" << setw(12)
+       << "max (us)" << endl;
+    os << fixed << setprecision(1);
+    for (size_t i = 0; i < TIMER_COUNT; ++i) {
+        const LatencyHistogram& timer = timers[i];
+        os << left << setw(12) << TIMER_NAMES[i] << right << setw(8)
+           << timer.count() << setw(12) << timer.percentile(0.5) / 1000.0
+           << setw(12) << timer.percentile(0.99) / 1000.0 << setw(12)
+           << timer.max() / 1000.0 << endl;
+    }
+
+    os << endl;
+    for (size_t i = 0; i < COUNTER_COUNT; ++i) {
+        os << left << setw(24) << COUNTER_NAMES[i] << right << setw(8)
+           << counters[i].load(memory_order_relaxed) << endl;
+    }
+}
+
+bool Stats::enabled() {
+#ifdef QWIRKLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+ScopedTimer::ScopedTimer(Timer timer)
+    : timer(timer), start(steady_clock::now()), stopped(false) {}
+
+ScopedTimer::~ScopedTimer() { stop(); }
+
+void ScopedTimer::stop() {
+    if (!stopped) {
+        stopped = true;
+        Stats::record(timer,
+            duration_cast<nanoseconds>(steady_clock::now() - start).count());
+    }
+}
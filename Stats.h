@@ -0,0 +1,150 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+using std::array;
+using std::atomic;
+using std::ostream;
+
+/**
+ * @note
+ * Latency histograms and counters for the hot paths of a turn. Recording is
+ * only compiled in when QWIRKLE_STATS is defined (make STATS=1), otherwise
+ * the STATS_* macros expand to nothing and cost nothing.
+ */
+enum Timer {
+    TIMER_PARSE,
+    TIMER_VALIDATE,
+    TIMER_SCORE,
+    TIMER_RENDER,
+    TIMER_SAVE,
+    TIMER_AUTOSAVE,
+    TIMER_LOAD,
+    TIMER_COUNT
+};
+
+enum Counter {
+    MOVES_ACCEPTED,
+    REJECTED_NOT_IN_HAND,
+    REJECTED_OCCUPIED,
+    REJECTED_NO_ADJACENT,
+    REJECTED_LINE_RULES,
+    REPLACES_ACCEPTED,
+    REPLACES_REJECTED,
+    QWIRKLES,
+    COUNTER_COUNT
+};
+
+class LatencyHistogram {
+public:
+    /**
+     * Construct an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * Record a latency, buckets are log-linear so every value is kept to
+     * within 1/8 of its magnitude.
+     *
+     * @param nanoseconds - the latency
+     */
+    void record(uint64_t nanoseconds);
+
+    /**
+     * Get the number of recorded latencies.
+     */
+    uint64_t count() const;
+
+    /**
+     * Get the highest latency recorded.
+     */
+    uint64_t max() const;
+
+    /**
+     * Get the latency at or below which the given fraction of values lie.
+     *
+     * @param fraction - the percentile between 0 and 1
+     * @return the highest latency equivalent to the percentile's bucket
+     */
+    uint64_t percentile(double fraction) const;
+
+private:
+    static constexpr size_t LINEAR_BUCKETS = 16;
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKETS = LINEAR_BUCKETS + 60 * SUB_BUCKETS;
+
+    static size_t bucketOf(uint64_t nanoseconds);
+    static uint64_t highestIn(size_t bucket);
+
+    array<atomic<uint64_t>, BUCKETS> buckets;
+    atomic<uint64_t> total;
+    atomic<uint64_t> highest;
+};
+
+class Stats {
+public:
+    /**
+     * Record the latency of a timed section.
+     */
+    static void record(Timer timer, uint64_t nanoseconds);
+
+    /**
+     * Increment a counter.
+     */
+    static void count(Counter counter);
+
+    /**
+     * Print p50/p99/max for every timer and the value of every counter.
+     *
+     * @param os - a reference to the output stream
+     */
+    static void print(ostream& os);
+
+    /**
+     * Query whether the instrumentation was compiled in.
+     */
+    static bool enabled();
+
+    static bool dumpOnExit;
+
+private:
+    static array<LatencyHistogram, TIMER_COUNT> timers;
+    static array<atomic<uint64_t>, COUNTER_COUNT> counters;
+};
+
+/**
+ * Records the time from construction until stop() or destruction.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Timer timer);
+
+    ~ScopedTimer();
+
+    /**
+     * Record the elapsed time now, later calls have no effect.
+     */
+    void stop();
+
+private:
+    const Timer timer;
+    const std::chrono::steady_clock::time_point start;
+    bool stopped;
+};
+
+#ifdef QWIRKLE_STATS
+#define STATS_TIME(timer) ScopedTimer statsTimer(timer)
+#define STATS_STOP() statsTimer.stop()
+#define STATS_COUNT(counter) Stats::count(counter)
+#else
+#define STATS_TIME(timer)
+#define STATS_STOP()
+#define STATS_COUNT(counter)
+#endif
+
+#endif // !STATS_H
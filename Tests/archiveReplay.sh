@@ -0,0 +1,12 @@
+#!/bin/sh
+# Writes the archive of a seeded tournament, checks it matches
+# archiveReplay.archive and reads it back with qwirkle-query, whose totals
+# are compared with archiveReplay.output. Run from the repository root.
+set -e
+archive=$(mktemp)
+trap 'rm -f "$archive"' EXIT
+
+./qwirkle-tournament --games 3 --seed 5 --threads 1 --archive "$archive" \
+    greedy random > /dev/null
+cmp "$archive" Tests/archiveReplay.archive
+./qwirkle-query "$archive" 2> /dev/null
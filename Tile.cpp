@@ -1,14 +1,35 @@
 
 #include "Tile.h"
+#include "TileCodes.h"
 
 using std::invalid_argument;
 
-Tile::Tile(Colour colour, Shape shape) : colour(colour), shape(shape) {}
+/**
+ * Find the index of a code, computed once so that lookups by kind are a
+ * single index.
+ */
+template <class Code>
+static size_t indexOf(const array<Code, MAX_TILE_TYPES>& codes, Code code) {
+    size_t index = 0;
+    while (index < codes.size() && codes.at(index) != code)
+        ++index;
+
+    return index;
+}
+
+Tile::Tile(Colour colour, Shape shape)
+    : colour(colour), shape(shape),
+      colourIndex(indexOf(COLOUR_CODES, colour)),
+      shapeIndex(indexOf(SHAPE_CODES, shape)) {}
 
 Colour Tile::getColour() const { return colour; }
 
 Shape Tile::getShape() const { return shape; }
 
+size_t Tile::getColourIndex() const { return colourIndex; }
+
+size_t Tile::getShapeIndex() const { return shapeIndex; }
+
 bool Tile::hasSameColour(const Tile& other) const {
     return colour == other.colour;
 }
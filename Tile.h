@@ -2,6 +2,7 @@
 #ifndef ASSIGN2_TILE_H
 #define ASSIGN2_TILE_H
 
+#include <cstddef>
 #include <ostream>
 
 using std::ostream;
@@ -33,6 +34,18 @@ public:
      */
     Shape getShape() const;
 
+    /**
+     * Get the index of the tile's colour in COLOUR_CODES, MAX_TILE_TYPES if
+     * the colour is unknown.
+     */
+    size_t getColourIndex() const;
+
+    /**
+     * Get the index of the tile's shape in SHAPE_CODES, MAX_TILE_TYPES if the
+     * shape is unknown.
+     */
+    size_t getShapeIndex() const;
+
     /**
      * Check if other has same colour as this.
      *
@@ -66,6 +79,8 @@ public:
 private:
     const Colour colour;
     const Shape shape;
+    const size_t colourIndex;
+    const size_t shapeIndex;
 };
 
 #endif // ASSIGN2_TILE_H
@@ -1,26 +1,43 @@
 
 #include "TileBag.h"
-#include "TileCodes.h"
 #include "PlayerHand.h"
-#include "Constants.h"
 
 #include <random>
 
 using std::length_error;
+using std::mt19937_64;
 using std::random_device;
 using std::uniform_int_distribution;
 
-TileBag::TileBag() : tiles(make_shared<LinkedList>()) {}
+template <class Rules>
+BasicTileBag<Rules>::BasicTileBag(const shared_ptr<Arena>& arena)
+    : arena(arena), tiles(allocate_shared<TileList>(
+        ArenaAllocator<TileList>(arena), arena)) {}
 
-TileBag::~TileBag() { tiles.reset(); }
+template <class Rules>
+BasicTileBag<Rules>::BasicTileBag(const BasicTileBag& bag)
+    : BasicTileBag(bag, bag.arena) {}
 
-void TileBag::fill() {
+template <class Rules>
+BasicTileBag<Rules>::BasicTileBag(const BasicTileBag& bag,
+    const shared_ptr<Arena>& arena)
+    : arena(arena), tiles(allocate_shared<TileList>(
+        ArenaAllocator<TileList>(arena), *bag.tiles, arena)) {}
+
+template <class Rules>
+BasicTileBag<Rules>::~BasicTileBag() { tiles.reset(); }
+
+template <class Rules>
+void BasicTileBag<Rules>::fill() {
     if (tiles->isEmpty()) {
-        for (size_t i = 0; i < COLOURS.size(); ++i) {
-            for (size_t j = 0; j < SHAPES.size(); ++j) {
-                // two of each colour and shape combination
-                tiles->addBack(make_shared<Tile>(COLOURS.at(i), SHAPES.at(j)));
-                tiles->addBack(make_shared<Tile>(COLOURS.at(i), SHAPES.at(j)));
+        ArenaAllocator<Tile> allocator(arena);
+        for (size_t i = 0; i < Rules::TYPES; ++i) {
+            for (size_t j = 0; j < Rules::TYPES; ++j) {
+                // the rule set's copies of each colour and shape combination
+                for (size_t copy = 0; copy < Rules::COPIES; ++copy) {
+                    tiles->addBack(allocate_shared<Tile>(
+                        allocator, Rules::colourAt(i), Rules::shapeAt(j)));
+                }
             }
         }
     } else {
@@ -28,50 +45,83 @@ void TileBag::fill() {
     }
 }
 
-void TileBag::shuffle() {
-    for (size_t i = 0; i < tiles->size(); ++i) {
-        size_t randomIndex = getRandomIndex();
+template <class Rules>
+void BasicTileBag<Rules>::shuffle() {
+    random_device engine;
+    shuffleWith(engine);
+}
 
-        shared_ptr<Tile> toBeReplaced = tiles->at(i);
-        shared_ptr<Tile> randomTile = tiles->at(randomIndex);
-        shared_ptr<Tile> replaced = toBeReplaced;
+template <class Rules>
+void BasicTileBag<Rules>::shuffle(uint64_t seed) {
+    mt19937_64 engine(seed);
+    shuffleWith(engine);
+}
 
-        tiles->insert(randomTile, i, true);
-        tiles->insert(replaced, randomIndex, true);
-    }
+template <class Rules>
+template <class Engine>
+void BasicTileBag<Rules>::shuffleWith(Engine& engine) {
+    // swap through an array as the list has no random access
+    vector<shared_ptr<Tile>, ArenaAllocator<shared_ptr<Tile>>> shuffled(
+        tiles->begin(), tiles->end(),
+        ArenaAllocator<shared_ptr<Tile>>(arena));
+
+    for (size_t i = 0; i < shuffled.size(); ++i)
+        std::swap(shuffled[i], shuffled[getRandomIndex(engine)]);
+
+    TileList::iterator current = tiles->begin();
+    for (const shared_ptr<Tile>& tile : shuffled)
+        *current++ = tile;
 }
 
-shared_ptr<PlayerHand> TileBag::getHand() {
-    if (tiles->size() < HAND_SIZE)
+template <class Rules>
+shared_ptr<BasicPlayerHand<Rules>> BasicTileBag<Rules>::getHand() {
+    if (tiles->size() < Rules::HAND_SIZE)
         throw length_error("insufficient number of tiles for TileBag::getHand");
 
-    shared_ptr<PlayerHand> hand = make_shared<PlayerHand>();
-    for (size_t i = 0; i < HAND_SIZE; ++i) {
-        hand->addTile(tiles->at(tiles->size() - 1));
+    shared_ptr<BasicPlayerHand<Rules>> hand =
+        allocate_shared<BasicPlayerHand<Rules>>(
+            ArenaAllocator<BasicPlayerHand<Rules>>(arena), arena);
+    for (size_t i = 0; i < Rules::HAND_SIZE; ++i) {
+        hand->addTile(tiles->back());
         tiles->removeBack();
     }
 
     return hand;
 }
 
-shared_ptr<LinkedList> TileBag::getTiles() { return tiles; }
+template <class Rules>
+shared_ptr<TileList> BasicTileBag<Rules>::getTiles() { return tiles; }
+
+template <class Rules>
+shared_ptr<const TileList> BasicTileBag<Rules>::getTiles() const {
+    return tiles;
+}
 
-shared_ptr<Tile> TileBag::replace(shared_ptr<Tile>& tile) {
-    shared_ptr<Tile> toBeReplaced = tiles->at(FIRST_POSITION);
+template <class Rules>
+shared_ptr<Tile> BasicTileBag<Rules>::replace(shared_ptr<Tile>& tile) {
+    shared_ptr<Tile> toBeReplaced = tiles->front();
     tiles->removeFront();
     tiles->addBack(tile);
 
     return toBeReplaced;
 }
 
-size_t TileBag::getRandomIndex() {
-    random_device engine;
+template <class Rules>
+template <class Engine>
+size_t BasicTileBag<Rules>::getRandomIndex(Engine& engine) {
     uniform_int_distribution<size_t> distribution(0, tiles->size() - 1);
 
     return distribution(engine);
 }
 
-ostream& operator<<(ostream& os, const TileBag& bag) {
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicTileBag<Rules>& bag) {
     os << *bag.tiles;
     return os;
 }
+
+template class BasicTileBag<StandardRules>;
+template ostream& operator<<(ostream&, const BasicTileBag<StandardRules>&);
+
+template class BasicTileBag<ExtendedRules>;
+template ostream& operator<<(ostream&, const BasicTileBag<ExtendedRules>&);
@@ -3,21 +3,49 @@
 #define TILE_BAG_H
 
 #include "LinkedList.h"
+#include "Tile.h"
+#include "Rules.h"
 
-class Tile;
-class PlayerHand;
+#include <cstdint>
 
-class TileBag {
+using std::make_shared;
+using std::allocate_shared;
+
+typedef LinkedList<shared_ptr<Tile>> TileList;
+
+template <class Rules>
+class BasicPlayerHand;
+
+template <class Rules>
+class BasicTileBag;
+
+template <class Rules>
+ostream& operator<<(ostream& os, const BasicTileBag<Rules>& bag);
+
+template <class Rules>
+class BasicTileBag {
 public:
     /**
-    * Construct a bag with an empty LinkedList.
+    * Construct a bag with an empty LinkedList, the tiles and nodes are
+    * allocated from the given arena or the heap if there is none.
     */
-    TileBag();
+    explicit BasicTileBag(const shared_ptr<Arena>& arena = nullptr);
+
+    /**
+     * Copy constructor, copies the list of tiles so the bags are independent.
+     */
+    BasicTileBag(const BasicTileBag& bag);
+
+    /**
+     * Copy a bag into one whose nodes are allocated from the given arena, or
+     * the heap if there is none. The tiles themselves are shared.
+     */
+    BasicTileBag(const BasicTileBag& bag, const shared_ptr<Arena>& arena);
 
     /**
      * Destructor to free the tiles in the bag.
      */
-    ~TileBag();
+    ~BasicTileBag();
 
     /**
      * Fill in the bag with maximum number of tiles possible.
@@ -30,18 +58,32 @@ public:
     void shuffle();
 
     /**
-     * Get a hand (6) of tiles.
+     * Shuffle the bag the same way every time for the same seed.
+     *
+     * @param seed - the seed of the shuffle
+     */
+    void shuffle(uint64_t seed);
+
+    /**
+     * Get a hand (Rules::HAND_SIZE) of tiles.
      *
      * @return a pointer to PlayerHand
      */
-    shared_ptr<PlayerHand> getHand();
+    shared_ptr<BasicPlayerHand<Rules>> getHand();
 
     /**
      * Get all the tiles in the bag.
      *
      * @return a pointer to a LinkedList of tiles
      * */
-    shared_ptr<LinkedList> getTiles();
+    shared_ptr<TileList> getTiles();
+
+    /**
+     * Get all the tiles in the bag as read-only.
+     *
+     * @return a pointer to a const LinkedList of tiles
+     * */
+    shared_ptr<const TileList> getTiles() const;
 
     /**
      * Replace a tile from the bag.
@@ -57,17 +99,28 @@ public:
      * @param os - a reference to the output stream
      * @param hand - a reference to the TileBag to be printed
      */
-    friend ostream& operator<<(ostream& os, const TileBag& bag);
+    friend ostream& operator<< <>(ostream& os, const BasicTileBag& bag);
 
 private:
+    /**
+     * Shuffle the bag with the given random number engine.
+     */
+    template <class Engine>
+    void shuffleWith(Engine& engine);
+
     /**
      * A random number generator.
      *
+     * @param engine - the random number engine
      * @return an index within the bounds of the bag
      */
-    size_t getRandomIndex();
+    template <class Engine>
+    size_t getRandomIndex(Engine& engine);
 
-    shared_ptr<LinkedList> tiles;
+    shared_ptr<Arena> arena;
+    shared_ptr<TileList> tiles;
 };
 
+typedef BasicTileBag<StandardRules> TileBag;
+
 #endif // !TILE_BAG_H
@@ -16,6 +16,11 @@ using std::array;
 #define BLUE 'B'
 #define PURPLE 'P'
 
+// Colours only used by rule sets with more than six colours
+#define WHITE 'W'
+#define CYAN 'C'
+#define MAGENTA 'M'
+
 // Shapes
 #define CIRCLE 1
 #define STAR_4 2
@@ -24,6 +29,8 @@ using std::array;
 #define STAR_6 5
 #define CLOVER 6
 
+#define MAX_TILE_TYPES 9
+
 /**
  * @note
  * Global variables made static, as well as const according to the style guide.
@@ -33,4 +40,14 @@ static const array<Colour, 6> COLOURS{
 static const array<Shape, 6> SHAPES{
     CIRCLE, STAR_4, DIAMOND, SQUARE, STAR_6, CLOVER};
 
+/**
+ * @note
+ * Every colour and shape a rule set can use, in kind order. The standard game
+ * uses the first six of each.
+ */
+static const array<Colour, MAX_TILE_TYPES> COLOUR_CODES{
+    RED, ORANGE, YELLOW, GREEN, BLUE, PURPLE, WHITE, CYAN, MAGENTA};
+static const array<Shape, MAX_TILE_TYPES> SHAPE_CODES{
+    CIRCLE, STAR_4, DIAMOND, SQUARE, STAR_6, CLOVER, 7, 8, 9};
+
 #endif // ASSIGN1_TILECODES_H
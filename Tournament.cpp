@@ -0,0 +1,443 @@
+#include "Tournament.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <thread>
+
+using std::endl;
+using std::lock_guard;
+using std::make_unique;
+using std::setw;
+using std::thread;
+
+// the most moves a game may take before it is called off as it stands
+static const size_t MAX_MOVES = 1000;
+
+// the z-score of a two-sided 95% confidence interval
+static const double Z_95 = 1.96;
+
+// how near a Wilson bound may come to 0 or 1 and still be given an Elo
+static const double WILSON_EPSILON = 1e-9;
+
+// the iterations allowed for the ratings to converge
+static const size_t RATING_ITERATIONS = 10000;
+
+/**
+ * Mix a number into a well spread 64-bit value, the splitmix64 finaliser.
+ */
+static uint64_t mix(uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+    return value ^ (value >> 31);
+}
+
+/**
+ * Get the Elo difference at which the stronger player is expected to score
+ * the given fraction of the points.
+ */
+static double eloOf(double fraction) {
+    return 400 * std::log10(fraction / (1 - fraction));
+}
+
+/**
+ * Write the Elo difference of a bound on the score fraction, which is
+ * infinite once the bound reaches no points or all of them.
+ */
+static void printElo(ostream& os, double fraction) {
+    // the Wilson bounds of a sweep only miss 0 or 1 by rounding
+    if (fraction < WILSON_EPSILON)
+        os << "-inf";
+    else if (fraction > 1 - WILSON_EPSILON)
+        os << "+inf";
+    else
+        os << std::showpos << eloOf(fraction) << std::noshowpos;
+}
+
+Tournament::Tournament(const vector<string>& configs, size_t gamesPerPairing,
+    uint64_t seed) : configs(configs) {
+    // fail early on a bad configuration
+    for (const string& config : configs)
+        Bot::create(config);
+
+    for (size_t first = 0; first < configs.size(); ++first) {
+        for (size_t second = first + 1; second < configs.size(); ++second) {
+            for (size_t game = 0; game < gamesPerPairing; ++game) {
+                // consecutive games share a deal with the seats swapped
+                uint64_t deal = mix(seed + game / 2);
+                if (game % 2 == 0)
+                    schedule.push_back({first, second, deal});
+                else
+                    schedule.push_back({second, first, deal});
+            }
+        }
+    }
+    results.resize(schedule.size());
+}
+
+void Tournament::run(size_t threads) {
+    if (threads == 0)
+        threads = std::max(1u, thread::hardware_concurrency());
+
+    // each thread starts with an equal run of the schedule
+    queues.clear();
+    for (size_t i = 0; i < threads; ++i) {
+        queues.push_back(make_unique<WorkQueue>());
+        for (size_t game = i * schedule.size() / threads;
+             game < (i + 1) * schedule.size() / threads; ++game)
+            queues.back()->games.push_back(game);
+    }
+
+    vector<thread> workers;
+    for (size_t i = 1; i < threads; ++i)
+        workers.emplace_back(&Tournament::work, this, i);
+    work(0);
+
+    for (thread& worker : workers)
+        worker.join();
+}
+
+void Tournament::exportTo(shared_ptr<TrainingWriter> writer) {
+    exporter = writer;
+}
+
+void Tournament::archiveTo(shared_ptr<ArchiveWriter> writer) {
+    archiver = writer;
+}
+
+void Tournament::useBook(shared_ptr<const OpeningBook> book) {
+    this->book = book;
+}
+
+size_t Tournament::getGameCount() const { return schedule.size(); }
+
+void Tournament::work(size_t worker) {
+    vector<unique_ptr<Bot>> bots;
+    for (const string& config : configs)
+        bots.push_back(Bot::create(config, book));
+
+    GameManager manager;
+    size_t game;
+    while (take(worker, game))
+        results[game] = play(schedule[game], bots, manager);
+}
+
+bool Tournament::take(size_t worker, size_t& game) {
+    {
+        WorkQueue& own = *queues[worker];
+        lock_guard<mutex> guard(own.lock);
+        if (!own.games.empty()) {
+            game = own.games.back();
+            own.games.pop_back();
+            return true;
+        }
+    }
+
+    // no games are added once the tournament runs, so empty queues stay empty
+    for (size_t i = 1; i < queues.size(); ++i) {
+        WorkQueue& victim = *queues[(worker + i) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.games.empty()) {
+            game = victim.games.front();
+            victim.games.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+Tournament::Result Tournament::play(const Game& game,
+    vector<unique_ptr<Bot>>& bots, GameManager& manager) const {
+    bool over = false;
+    bool failed = false;
+    manager.listener = [&over, &failed](const string& message, State state) {
+        over = over || state == GAME_OVER;
+        failed = state == PLACE_FAILURE || state == REPLACE_FAILURE;
+    };
+
+    // the names only tell the seats apart
+    manager.beginGame("FIRST", "SECOND", game.seed);
+    mt19937_64 random(mix(game.seed ^ (game.first << 32 | game.second)));
+
+    // the hands were drawn from the back of the bag one tile at a time, so
+    // the bag as shuffled is what is left of it and then each hand reversed
+    ArchivedGame archived;
+    if (archiver) {
+        archived.names = {configs[game.first], configs[game.second]};
+        for (const shared_ptr<Tile>& tile : *manager.bag->getTiles())
+            archived.deal.push_back(StandardRules::kindOf(*tile));
+        for (const Player* player :
+             {manager.player2.get(), manager.player1.get()}) {
+            size_t drawn = archived.deal.size();
+            for (const shared_ptr<Tile>& tile :
+                 *player->getHand()->getTiles())
+                archived.deal.push_back(StandardRules::kindOf(*tile));
+            std::reverse(archived.deal.begin() + drawn, archived.deal.end());
+        }
+    }
+
+    vector<TrainingRecord> records;
+    size_t passes = 0;
+    for (size_t moves = 0; !over && passes < 2 && moves < MAX_MOVES;
+         ++moves) {
+        bool firstToMove = manager.currentPlayer == manager.player1;
+        Bot& bot = *bots[firstToMove ? game.first : game.second];
+        BotMove move = bot.choose(manager, random);
+        Tile tile(StandardRules::colourAt(move.kind / StandardRules::TYPES),
+            StandardRules::shapeAt(move.kind % StandardRules::TYPES));
+
+        size_t before = manager.currentPlayer->getScore();
+        if (exporter)
+            records.push_back(describe(manager, move, moves));
+
+        failed = true;
+        if (!move.replace)
+            manager.placeTile(
+                tile.getColour(), tile.getShape(), move.row, move.column);
+        else if (!manager.bag->getTiles()->isEmpty())
+            manager.replaceTile(tile.getColour(), tile.getShape());
+
+        // a player who cannot move passes, the game ends once both have
+        if (failed) {
+            manager.switchPlayer();
+            ++passes;
+        } else {
+            passes = 0;
+        }
+
+        if (archiver) {
+            archived.moves.push_back({
+                failed ? ArchivedMove::PASS : move.replace
+                    ? ArchivedMove::REPLACE : ArchivedMove::PLACE,
+                uint8_t(move.kind), uint8_t(move.row), uint8_t(move.column)});
+        }
+
+        if (exporter) {
+            // a move may copy the player, so look them up again by seat
+            const Player& mover =
+                firstToMove ? *manager.player1 : *manager.player2;
+            records.back().points = mover.getScore() - before;
+            if (failed)
+                records.back().action = TrainingFormat::PASS;
+        }
+    }
+
+    Result result{manager.player1->getScore(), manager.player2->getScore()};
+    manager.resetGame();
+
+    if (archiver) {
+        archived.scores = {uint16_t(result.firstScore),
+            uint16_t(result.secondScore)};
+        archiver->add(archived);
+    }
+
+    if (exporter) {
+        int16_t margin = int16_t(result.firstScore) -
+            int16_t(result.secondScore);
+        for (TrainingRecord& record : records)
+            record.result = record.seat == 1 ? margin : -margin;
+        exporter->append(records);
+    }
+
+    return result;
+}
+
+TrainingRecord Tournament::describe(const GameManager& manager,
+    const BotMove& move, size_t ply) {
+    const LineIndex<StandardRules>& index = manager.board->getIndex();
+    const Player& mover = *manager.currentPlayer;
+    TrainingRecord record{};
+
+    for (size_t row = 0; row < StandardRules::BOARD_LENGTH; ++row) {
+        for (size_t column = 0; column < StandardRules::BOARD_LENGTH;
+             ++column) {
+            size_t kind = index.kindAt(row, column);
+            record.board[row * StandardRules::BOARD_LENGTH + column] =
+                kind == LineIndex<StandardRules>::NO_TILE
+                    ? TrainingFormat::EMPTY_CELL : kind;
+        }
+    }
+
+    for (const shared_ptr<Tile>& tile : *mover.getHand()->getTiles())
+        ++record.hand[StandardRules::kindOf(*tile)];
+    for (size_t kind = 0; kind < StandardRules::KINDS; ++kind)
+        record.unseen[kind] = mover.getUnseen().count(kind);
+
+    record.action = move.replace
+        ? TrainingFormat::REPLACE : TrainingFormat::PLACE;
+    record.kind = move.kind;
+    record.row = move.replace ? 0 : move.row;
+    record.column = move.replace ? 0 : move.column;
+    record.seat = &mover == manager.player1.get() ? 1 : 2;
+    record.ply = ply;
+
+    return record;
+}
+
+vector<vector<Tournament::Record>> Tournament::tally() const {
+    vector<vector<Record>> records(
+        configs.size(), vector<Record>(configs.size(), Record{}));
+
+    for (size_t i = 0; i < schedule.size(); ++i) {
+        const Game& game = schedule[i];
+        double margin = double(results[i].firstScore) -
+            double(results[i].secondScore);
+        Record& first = records[game.first][game.second];
+        Record& second = records[game.second][game.first];
+
+        ++first.games;
+        ++second.games;
+        if (margin > 0)
+            ++first.wins;
+        else if (margin < 0)
+            ++second.wins;
+        else {
+            ++first.draws;
+            ++second.draws;
+        }
+
+        first.margins += margin;
+        second.margins -= margin;
+        first.squaredMargins += margin * margin;
+        second.squaredMargins += margin * margin;
+    }
+
+    return records;
+}
+
+void Tournament::rate(const vector<vector<Record>>& records,
+    vector<double>& ratings, vector<double>& errors) const {
+    size_t bots = configs.size();
+    vector<double> strengths(bots, 1);
+
+    // minorisation-maximisation updates of each strength in turn
+    for (size_t iteration = 0; iteration < RATING_ITERATIONS; ++iteration) {
+        double change = 0;
+        for (size_t i = 0; i < bots; ++i) {
+            double points = 0;
+            double expected = 0;
+            for (size_t j = 0; j < bots; ++j) {
+                const Record& record = records[i][j];
+                if (i == j || record.games == 0)
+                    continue;
+                points += record.wins + 0.5 * record.draws + 0.5;
+                expected += (record.games + 1) /
+                    (strengths[i] + strengths[j]);
+            }
+
+            double updated = expected > 0 ? points / expected : 1;
+            change = std::max(change,
+                std::fabs(std::log(updated / strengths[i])));
+            strengths[i] = updated;
+        }
+
+        if (change < 1e-9)
+            break;
+    }
+
+    // the information about each log strength gives its standard error
+    double mean = 0;
+    for (double strength : strengths)
+        mean += std::log(strength) / bots;
+
+    double scale = 400 / std::log(10);
+    ratings.assign(bots, 0);
+    errors.assign(bots, 0);
+    for (size_t i = 0; i < bots; ++i) {
+        double information = 0;
+        for (size_t j = 0; j < bots; ++j) {
+            double p = strengths[i] / (strengths[i] + strengths[j]);
+            if (i != j)
+                information += (records[i][j].games + 1) * p * (1 - p);
+        }
+
+        ratings[i] = scale * (std::log(strengths[i]) - mean);
+        errors[i] = information > 0
+            ? Z_95 * scale / std::sqrt(information) : 0;
+    }
+}
+
+void Tournament::report(ostream& os) const {
+    vector<vector<Record>> records = tally();
+    vector<double> ratings;
+    vector<double> errors;
+    rate(records, ratings, errors);
+
+    size_t width = 3;
+    for (const string& config : configs)
+        width = std::max(width, config.size());
+
+    os << std::fixed << std::setprecision(1);
+    os << std::left << setw(width) << "Bot" << std::right << setw(9)
+       << "Games" << setw(9) << "Win %" << setw(18) << "Margin"
+       << setw(18) << "Elo" << endl;
+
+    for (size_t i = 0; i < configs.size(); ++i) {
+        Record total{};
+        for (const Record& record : records[i]) {
+            total.games += record.games;
+            total.wins += record.wins;
+            total.draws += record.draws;
+            total.margins += record.margins;
+            total.squaredMargins += record.squaredMargins;
+        }
+
+        double games = std::max<size_t>(total.games, 1);
+        double mean = total.margins / games;
+        double spread = std::sqrt(std::max(0.0,
+            total.squaredMargins / games - mean * mean) / games);
+        os << std::left << setw(width) << configs[i] << std::right
+           << setw(9) << total.games
+           << setw(9) << 100 * (total.wins + 0.5 * total.draws) / games
+           << setw(10) << std::showpos << mean << std::noshowpos
+           << " +- " << setw(4) << Z_95 * spread
+           << setw(10) << std::showpos << ratings[i] << std::noshowpos
+           << " +- " << setw(4) << errors[i] << endl;
+    }
+
+    os << endl << "Bot Elo: Bradley-Terry rating against the mean bot, "
+       "+- 95% error" << endl;
+    os << "Pairing Elo: difference implied by the pairing's score, "
+       "[95% Wilson interval]" << endl;
+
+    os << endl;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        for (size_t j = i + 1; j < configs.size(); ++j) {
+            const Record& record = records[i][j];
+            if (record.games == 0)
+                continue;
+
+            double games = record.games;
+            double score = (record.wins + 0.5 * record.draws) / games;
+            double mean = record.margins / games;
+            double spread = std::sqrt(std::max(0.0,
+                record.squaredMargins / games - mean * mean) / games);
+
+            // the Wilson interval of the score fraction maps on to an Elo
+            // interval, while the estimate of a clean sweep counts half a
+            // game dropped so that it stays finite
+            double z2 = Z_95 * Z_95 / games;
+            double centre = (score + z2 / 2) / (1 + z2);
+            double half = Z_95 * std::sqrt(score * (1 - score) / games +
+                z2 / (4 * games)) / (1 + z2);
+            double bound = 0.5 / games;
+            double clamped = std::min(1 - bound, std::max(bound, score));
+
+            os << configs[i] << " vs " << configs[j] << ": " << record.games
+               << " games, " << record.wins << "-" << record.draws << "-"
+               << record.games - record.wins - record.draws << ", margin "
+               << std::showpos << mean << std::noshowpos << " +- "
+               << Z_95 * spread << ", Elo ";
+            printElo(os, clamped);
+            os << " [";
+            printElo(os, centre - half);
+            os << ", ";
+            printElo(os, centre + half);
+            os << "]" << endl;
+        }
+    }
+    os << std::defaultfloat;
+}
@@ -0,0 +1,195 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include "Bot.h"
+#include "GameArchive.h"
+#include "TrainingExport.h"
+
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::deque;
+using std::mutex;
+using std::ostream;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+/**
+ * @note
+ * Plays a round robin between bots, a number of games for every pairing.
+ * Games are dealt from a shared sequence of seeds, each seed used for every
+ * pairing and played twice with the bots swapping seats, so neither luck of
+ * the deal nor moving first favours a bot. Every game has its own manager,
+ * so games run on all cores at once, scheduled by a work-stealing pool: each
+ * thread takes games from the back of its own queue and steals from the
+ * front of another's once it runs out.
+ */
+class Tournament {
+public:
+    /**
+     * Construct a tournament between bots.
+     *
+     * @param configs - the configuration of each bot, see Bot::create
+     * @param gamesPerPairing - the number of games each pair of bots plays
+     * @param seed - the seed the deals are derived from
+     * @throws invalid_argument if a configuration is not recognised
+     */
+    Tournament(const vector<string>& configs, size_t gamesPerPairing,
+        uint64_t seed);
+
+    /**
+     * Play every game.
+     *
+     * @param threads - the number of threads, 0 for one per core
+     */
+    void run(size_t threads);
+
+    /**
+     * Export every position played and the move chosen in it, each game's
+     * records appended together once it ends. Call before run.
+     *
+     * @param writer - the training file to write to
+     */
+    void exportTo(shared_ptr<TrainingWriter> writer);
+
+    /**
+     * Archive every game, with the bots' configurations as the names of the
+     * players, each game added once it ends. Call before run.
+     *
+     * @param writer - the archive to add to
+     */
+    void archiveTo(shared_ptr<ArchiveWriter> writer);
+
+    /**
+     * Give the bots that search an opening book. Call before run.
+     *
+     * @param book - the book
+     */
+    void useBook(shared_ptr<const OpeningBook> book);
+
+    /**
+     * Write each bot's win rate, score margin and Bradley-Terry Elo rating,
+     * and for each pairing the same with the Elo difference its own score
+     * implies, with 95% confidence intervals.
+     *
+     * @param os - the stream to write to
+     */
+    void report(ostream& os) const;
+
+    /**
+     * Get the number of games in the tournament.
+     */
+    size_t getGameCount() const;
+
+private:
+    /**
+     * A game between two bots, the first of which moves first.
+     */
+    struct Game {
+        size_t first;
+        size_t second;
+        uint64_t seed;
+    };
+
+    /**
+     * The final scores of a game.
+     */
+    struct Result {
+        size_t firstScore;
+        size_t secondScore;
+    };
+
+    /**
+     * A thread's queue of games, guarded by its lock.
+     */
+    struct WorkQueue {
+        mutex lock;
+        deque<size_t> games;
+    };
+
+    /**
+     * The results between one bot and another, from the first's side.
+     */
+    struct Record {
+        size_t games;
+        size_t wins;
+        size_t draws;
+
+        // the sums of the score margins and their squares
+        double margins;
+        double squaredMargins;
+    };
+
+    /**
+     * Take games from the thread's queue, or steal them, until none are
+     * left.
+     *
+     * @param worker - the index of the thread's queue
+     */
+    void work(size_t worker);
+
+    /**
+     * Take a game to play, from the back of the thread's own queue or the
+     * front of another thread's.
+     *
+     * @param worker - the index of the thread's queue
+     * @param game - set to the game taken
+     * @return false if no game is left
+     */
+    bool take(size_t worker, size_t& game);
+
+    /**
+     * Play a game to its end.
+     *
+     * @param game - the game
+     * @param bots - the thread's own instance of each bot
+     * @param manager - the thread's game manager
+     * @return the final scores
+     */
+    Result play(const Game& game, vector<unique_ptr<Bot>>& bots,
+        GameManager& manager) const;
+
+    /**
+     * Describe the position before a move as a training record, its result
+     * left to be filled in once the game ends.
+     *
+     * @param manager - the game
+     * @param move - the move chosen
+     * @param ply - the number of moves made before it
+     */
+    static TrainingRecord describe(const GameManager& manager,
+        const BotMove& move, size_t ply);
+
+    /**
+     * Get the record of a bot against every other, over every game played.
+     */
+    vector<vector<Record>> tally() const;
+
+    /**
+     * Fit a Bradley-Terry model to the points each bot took off each other,
+     * with a drawn game added to every pairing so that a bot that wins
+     * every game still has a finite rating.
+     *
+     * @param records - the record of each bot against each other
+     * @param ratings - set to the Elo rating of each bot, averaging 0
+     * @param errors - set to the half-width of each rating's 95% interval
+     */
+    void rate(const vector<vector<Record>>& records, vector<double>& ratings,
+        vector<double>& errors) const;
+
+    vector<string> configs;
+    vector<Game> schedule;
+    vector<Result> results;
+    vector<unique_ptr<WorkQueue>> queues;
+    shared_ptr<TrainingWriter> exporter;
+    shared_ptr<ArchiveWriter> archiver;
+    shared_ptr<const OpeningBook> book;
+};
+
+#endif // !TOURNAMENT_H
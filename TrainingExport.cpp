@@ -0,0 +1,246 @@
+#include "TrainingExport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::endl;
+using std::lock_guard;
+using std::runtime_error;
+using std::unique_lock;
+
+constexpr uint32_t TrainingFormat::VERSION;
+constexpr uint8_t TrainingFormat::EMPTY_CELL;
+constexpr size_t TrainingFormat::ALIGNMENT;
+constexpr size_t TrainingFormat::DEFAULT_CHUNK_CAPACITY;
+
+static const char FILE_MAGIC[8] = {'Q', 'W', 'K', 'T', 'R', 'A', 'I', 'N'};
+static const char CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+
+/**
+ * Round a size up to the alignment of the format.
+ */
+static size_t align(size_t size) {
+    return (size + TrainingFormat::ALIGNMENT - 1) /
+        TrainingFormat::ALIGNMENT * TrainingFormat::ALIGNMENT;
+}
+
+size_t TrainingFormat::columnWidth(Column column) {
+    size_t width = 1;
+    if (column == BOARD)
+        width = StandardRules::CELLS;
+    else if (column == HAND || column == UNSEEN)
+        width = StandardRules::KINDS;
+    else if (column == PLY || column == RESULT)
+        width = 2;
+
+    return width;
+}
+
+size_t TrainingFormat::columnOffset(Column column, size_t capacity) {
+    size_t offset = sizeof(ChunkHeader);
+    for (size_t before = 0; before < column; ++before)
+        offset += align(columnWidth(Column(before)) * capacity);
+
+    return offset;
+}
+
+size_t TrainingFormat::chunkBytes(size_t capacity) {
+    return columnOffset(COLUMN_COUNT, capacity);
+}
+
+/**
+ * Write a whole buffer to a file.
+ *
+ * @return true if every byte was written
+ */
+static bool writeAll(int file, const uint8_t* data, size_t size) {
+    size_t offset = 0;
+    while (offset < size) {
+        ssize_t count = write(file, data + offset, size - offset);
+        if (count <= 0 && errno != EINTR)
+            return false;
+        offset += count > 0 ? count : 0;
+    }
+
+    return true;
+}
+
+TrainingWriter::TrainingWriter(const string& fileName, size_t capacity)
+    : fileName(fileName), capacity(capacity), count(0), total(0),
+      full(false), stopping(false) {
+    file = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+        0644);
+    if (file < 0)
+        throw runtime_error(fileName + ": " + strerror(errno));
+
+    TrainingFormat::FileHeader header{};
+    memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = TrainingFormat::VERSION;
+    header.cells = StandardRules::CELLS;
+    header.kinds = StandardRules::KINDS;
+    header.chunkCapacity = capacity;
+    header.chunkBytes = TrainingFormat::chunkBytes(capacity);
+    if (!writeAll(file, reinterpret_cast<const uint8_t*>(&header),
+            sizeof(header))) {
+        close(file);
+        throw runtime_error(fileName + ": " + strerror(errno));
+    }
+
+    filling.assign(header.chunkBytes, 0);
+    spare.assign(header.chunkBytes, 0);
+    writer = thread(&TrainingWriter::run, this);
+}
+
+TrainingWriter::~TrainingWriter() {
+    {
+        unique_lock<mutex> guard(lock);
+        if (count > 0)
+            handOver(guard);
+        stopping = true;
+    }
+
+    handedOver.notify_one();
+    writer.join();
+    close(file);
+}
+
+void TrainingWriter::append(const vector<TrainingRecord>& records) {
+    unique_lock<mutex> guard(lock);
+    for (const TrainingRecord& record : records) {
+        copy(record);
+        if (count == capacity)
+            handOver(guard);
+    }
+}
+
+size_t TrainingWriter::getRecordCount() const {
+    lock_guard<mutex> guard(lock);
+    return total;
+}
+
+void TrainingWriter::copy(const TrainingRecord& record) {
+    typedef TrainingFormat F;
+    uint8_t* chunk = filling.data();
+    memcpy(chunk + F::columnOffset(F::BOARD, capacity) +
+        count * StandardRules::CELLS, record.board.data(),
+        StandardRules::CELLS);
+    memcpy(chunk + F::columnOffset(F::HAND, capacity) +
+        count * StandardRules::KINDS, record.hand.data(),
+        StandardRules::KINDS);
+    memcpy(chunk + F::columnOffset(F::UNSEEN, capacity) +
+        count * StandardRules::KINDS, record.unseen.data(),
+        StandardRules::KINDS);
+
+    chunk[F::columnOffset(F::ACTION, capacity) + count] = record.action;
+    chunk[F::columnOffset(F::KIND, capacity) + count] = record.kind;
+    chunk[F::columnOffset(F::ROW, capacity) + count] = record.row;
+    chunk[F::columnOffset(F::COLUMN, capacity) + count] = record.column;
+    chunk[F::columnOffset(F::SEAT, capacity) + count] = record.seat;
+    chunk[F::columnOffset(F::POINTS, capacity) + count] = record.points;
+    memcpy(chunk + F::columnOffset(F::PLY, capacity) + 2 * count,
+        &record.ply, 2);
+    memcpy(chunk + F::columnOffset(F::RESULT, capacity) + 2 * count,
+        &record.result, 2);
+
+    ++count;
+    ++total;
+}
+
+void TrainingWriter::handOver(unique_lock<mutex>& guard) {
+    written.wait(guard, [this] { return !full; });
+
+    TrainingFormat::ChunkHeader header{};
+    memcpy(header.magic, CHUNK_MAGIC, sizeof(header.magic));
+    header.count = count;
+    memcpy(filling.data(), &header, sizeof(header));
+
+    filling.swap(spare);
+    count = 0;
+    full = true;
+    handedOver.notify_one();
+}
+
+void TrainingWriter::run() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping || full) {
+        handedOver.wait(guard, [this] { return stopping || full; });
+
+        if (full) {
+            // the spare is only touched again once it is marked written
+            guard.unlock();
+            if (!writeAll(file, spare.data(), spare.size()))
+                cerr << "Export to " << fileName << " failed." << endl;
+            guard.lock();
+
+            full = false;
+            written.notify_all();
+        }
+    }
+}
+
+TrainingReader::TrainingReader(const string& fileName)
+    : data(nullptr), size(0), capacity(0), chunks(0) {
+    int file = open(fileName.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) < 0) {
+        if (file >= 0)
+            close(file);
+        throw runtime_error(fileName + ": " + strerror(errno));
+    }
+
+    size = status.st_size;
+    void* mapped = size > 0
+        ? mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0) : MAP_FAILED;
+    close(file);
+    if (mapped == MAP_FAILED)
+        throw runtime_error(fileName + ": cannot be mapped");
+    data = static_cast<const uint8_t*>(mapped);
+
+    TrainingFormat::FileHeader header;
+    bool valid = size >= sizeof(header);
+    if (valid) {
+        memcpy(&header, data, sizeof(header));
+        capacity = header.chunkCapacity;
+        valid = memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) == 0 &&
+            header.version == TrainingFormat::VERSION &&
+            header.cells == StandardRules::CELLS &&
+            header.kinds == StandardRules::KINDS && capacity > 0 &&
+            header.chunkBytes == TrainingFormat::chunkBytes(capacity) &&
+            (size - sizeof(header)) % header.chunkBytes == 0;
+    }
+
+    if (!valid) {
+        munmap(const_cast<uint8_t*>(data), size);
+        throw runtime_error(fileName + ": not a training file");
+    }
+    chunks = (size - sizeof(header)) / header.chunkBytes;
+}
+
+TrainingReader::~TrainingReader() {
+    munmap(const_cast<uint8_t*>(data), size);
+}
+
+size_t TrainingReader::getChunkCount() const { return chunks; }
+
+size_t TrainingReader::getRecordCount(size_t chunk) const {
+    TrainingFormat::ChunkHeader header;
+    memcpy(&header, data + sizeof(TrainingFormat::FileHeader) +
+        chunk * TrainingFormat::chunkBytes(capacity), sizeof(header));
+
+    return header.count;
+}
+
+const uint8_t* TrainingReader::getColumn(
+    size_t chunk, TrainingFormat::Column column) const {
+    return data + sizeof(TrainingFormat::FileHeader) +
+        chunk * TrainingFormat::chunkBytes(capacity) +
+        TrainingFormat::columnOffset(column, capacity);
+}
@@ -0,0 +1,244 @@
+#ifndef TRAINING_EXPORT_H
+#define TRAINING_EXPORT_H
+
+#include "Rules.h"
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::array;
+using std::condition_variable;
+using std::mutex;
+using std::unique_lock;
+using std::string;
+using std::thread;
+using std::vector;
+
+/**
+ * A position of the standard game with the move chosen in it, as exported
+ * for training.
+ */
+struct TrainingRecord {
+    // the kind in each cell, row by row, TrainingFormat::EMPTY_CELL if empty
+    array<uint8_t, StandardRules::CELLS> board;
+
+    // the number of each kind in the mover's hand and not yet seen by them
+    array<uint8_t, StandardRules::KINDS> hand;
+    array<uint8_t, StandardRules::KINDS> unseen;
+
+    // a TrainingFormat::Action, the kind and the cell of a placement
+    uint8_t action;
+    uint8_t kind;
+    uint8_t row;
+    uint8_t column;
+
+    // the mover's seat, 1 or 2, and the points the move scored
+    uint8_t seat;
+    uint8_t points;
+
+    // the move's number in its game, from 0
+    uint16_t ply;
+
+    // the mover's final score less their opponent's
+    int16_t result;
+};
+
+/**
+ * @note
+ * The layout of a training file, read by mapping it into memory as it is.
+ * All values are little-endian. A file is a 64 byte header then chunks of a
+ * fixed size, each a 64 byte chunk header then one array per field of
+ * TrainingRecord, every array sized for a full chunk and starting on a 64
+ * byte boundary. A column of a chunk is therefore at a fixed offset and its
+ * records are contiguous, and only the last chunk holds fewer records than
+ * it has room for.
+ */
+struct TrainingFormat {
+    enum Action : uint8_t {
+        PLACE = 0,
+        REPLACE = 1,
+        PASS = 2
+    };
+
+    enum Column {
+        BOARD,
+        HAND,
+        UNSEEN,
+        ACTION,
+        KIND,
+        ROW,
+        COLUMN,
+        SEAT,
+        POINTS,
+        PLY,
+        RESULT,
+        COLUMN_COUNT
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t cells;
+        uint32_t kinds;
+        uint32_t chunkCapacity;
+        uint64_t chunkBytes;
+        uint8_t reserved[32];
+    };
+
+    struct ChunkHeader {
+        char magic[4];
+        uint32_t count;
+        uint8_t reserved[56];
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "file header must be 64 bytes");
+    static_assert(sizeof(ChunkHeader) == 64, "chunk header must be 64 bytes");
+
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint8_t EMPTY_CELL = UINT8_MAX;
+    static constexpr size_t ALIGNMENT = 64;
+    static constexpr size_t DEFAULT_CHUNK_CAPACITY = 4096;
+
+    /**
+     * Get the bytes one record takes in a column.
+     */
+    static size_t columnWidth(Column column);
+
+    /**
+     * Get the offset of a column from the start of its chunk.
+     *
+     * @param column - the column
+     * @param capacity - the number of records a chunk has room for
+     */
+    static size_t columnOffset(Column column, size_t capacity);
+
+    /**
+     * Get the size of a chunk.
+     *
+     * @param capacity - the number of records a chunk has room for
+     */
+    static size_t chunkBytes(size_t capacity);
+};
+
+/**
+ * @note
+ * Streams training records to a file from any number of threads. Records
+ * are copied into the columns of the chunk being filled, and a full chunk is
+ * swapped with a spare and handed to a writer thread, so the threads making
+ * records only wait on the disk when both buffers are full.
+ */
+class TrainingWriter {
+public:
+    /**
+     * Create a training file and start its writer thread.
+     *
+     * @param fileName - the name of the file
+     * @param capacity - the number of records per chunk
+     * @throws runtime_error if the file cannot be created
+     */
+    TrainingWriter(const string& fileName,
+        size_t capacity = TrainingFormat::DEFAULT_CHUNK_CAPACITY);
+
+    /**
+     * Destructor to write the last partial chunk and stop the writer thread.
+     */
+    ~TrainingWriter();
+
+    /**
+     * Add records to the file, kept together in the order given.
+     *
+     * @param records - the records
+     */
+    void append(const vector<TrainingRecord>& records);
+
+    /**
+     * Get the number of records added so far.
+     */
+    size_t getRecordCount() const;
+
+private:
+    /**
+     * Copy a record into the chunk being filled.
+     */
+    void copy(const TrainingRecord& record);
+
+    /**
+     * Hand the chunk being filled to the writer thread, waiting for the
+     * spare chunk to be written first. The lock must be held.
+     */
+    void handOver(unique_lock<mutex>& guard);
+
+    /**
+     * The writer thread loop, writes chunks as they are handed over.
+     */
+    void run();
+
+    const string fileName;
+    const size_t capacity;
+    int file;
+    vector<uint8_t> filling;
+    vector<uint8_t> spare;
+    size_t count;
+    size_t total;
+
+    // whether the spare holds a full chunk still to be written
+    bool full;
+    bool stopping;
+    mutable mutex lock;
+    condition_variable handedOver;
+    condition_variable written;
+    thread writer;
+};
+
+/**
+ * @note
+ * A training file mapped read-only into memory, its columns read in place.
+ */
+class TrainingReader {
+public:
+    /**
+     * Map a training file.
+     *
+     * @param fileName - the name of the file
+     * @throws runtime_error if the file cannot be mapped or is not valid
+     */
+    explicit TrainingReader(const string& fileName);
+
+    /**
+     * Destructor to unmap the file.
+     */
+    ~TrainingReader();
+
+    /**
+     * Get the number of chunks in the file.
+     */
+    size_t getChunkCount() const;
+
+    /**
+     * Get the number of records in a chunk.
+     */
+    size_t getRecordCount(size_t chunk) const;
+
+    /**
+     * Get a column of a chunk, getRecordCount(chunk) values each of
+     * TrainingFormat::columnWidth(column) bytes.
+     *
+     * @param chunk - the chunk
+     * @param column - the column
+     */
+    const uint8_t* getColumn(size_t chunk, TrainingFormat::Column column)
+        const;
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t capacity;
+    size_t chunks;
+};
+
+#endif // !TRAINING_EXPORT_H
@@ -0,0 +1,132 @@
+#include "UnseenTiles.h"
+
+template <class Rules>
+BasicUnseenTiles<Rules>::BasicUnseenTiles() : unseenTotal(Rules::TILES) {
+    unseen.fill(Rules::COPIES);
+    held.fill(0);
+}
+
+template <class Rules>
+void BasicUnseenTiles<Rules>::recount(
+    const BasicGameBoard<Rules>& board, const BasicPlayerHand<Rules>& hand) {
+    unseen.fill(Rules::COPIES);
+    held.fill(0);
+    unseenTotal = Rules::TILES;
+
+    // every copy on the board is seen, as many as the rules have
+    for (size_t kind = 0; kind < Rules::KINDS; ++kind) {
+        size_t placed = board.countOf(kind);
+        unseen[kind] -= placed;
+        unseenTotal -= placed;
+    }
+
+    for (const shared_ptr<Tile>& tile : *hand.getTiles())
+        tileDrawn(*tile);
+}
+
+template <class Rules>
+void BasicUnseenTiles<Rules>::tilePlaced(const Tile& tile, bool fromOwnHand) {
+    size_t kind = Rules::kindOf(tile);
+    if (kind >= Rules::KINDS)
+        return;
+
+    // a tile from the player's own hand was already seen by them
+    if (fromOwnHand && held[kind] > 0) {
+        --held[kind];
+    } else if (unseen[kind] > 0) {
+        --unseen[kind];
+        --unseenTotal;
+    }
+}
+
+template <class Rules>
+void BasicUnseenTiles<Rules>::tileDrawn(const Tile& tile) {
+    size_t kind = Rules::kindOf(tile);
+    if (kind >= Rules::KINDS || unseen[kind] == 0)
+        return;
+
+    --unseen[kind];
+    --unseenTotal;
+    ++held[kind];
+}
+
+template <class Rules>
+void BasicUnseenTiles<Rules>::tileReturned(const Tile& tile) {
+    size_t kind = Rules::kindOf(tile);
+    if (kind >= Rules::KINDS || held[kind] == 0)
+        return;
+
+    --held[kind];
+    ++unseen[kind];
+    ++unseenTotal;
+}
+
+template <class Rules>
+size_t BasicUnseenTiles<Rules>::count(size_t kind) const {
+    return kind < Rules::KINDS ? unseen[kind] : 0;
+}
+
+template <class Rules>
+size_t BasicUnseenTiles<Rules>::total() const { return unseenTotal; }
+
+template <class Rules>
+double BasicUnseenTiles<Rules>::drawProbability(size_t kind) const {
+    return unseenTotal == 0
+        ? 0 : static_cast<double>(count(kind)) / unseenTotal;
+}
+
+template <class Rules>
+bool BasicUnseenTiles<Rules>::canCompleteQwirkle(const TileList& line) const {
+    uint32_t colours = 0;
+    uint32_t shapes = 0;
+    size_t colourIndex = 0;
+    size_t shapeIndex = 0;
+
+    for (const shared_ptr<Tile>& tile : line) {
+        size_t kind = Rules::kindOf(*tile);
+        if (kind >= Rules::KINDS)
+            return false;
+
+        colourIndex = kind / Rules::TYPES;
+        shapeIndex = kind % Rules::TYPES;
+        colours |= 1u << colourIndex;
+        shapes |= 1u << shapeIndex;
+    }
+
+    // an empty line could still become a line of any colour or shape
+    if (line.isEmpty()) {
+        bool completable = false;
+        for (size_t i = 0; i < Rules::TYPES && !completable; ++i) {
+            completable = canComplete(true, i, 0) ||
+                canComplete(false, i, 0);
+        }
+
+        return completable;
+    }
+
+    // a line of one tile could still become either kind of line
+    bool sharesColour = (colours & (colours - 1)) == 0;
+    bool sharesShape = (shapes & (shapes - 1)) == 0;
+
+    return (sharesColour && canComplete(true, colourIndex, shapes)) ||
+        (sharesShape && canComplete(false, shapeIndex, colours));
+}
+
+template <class Rules>
+bool BasicUnseenTiles<Rules>::canComplete(
+    bool sharesColour, size_t shared, uint32_t present) const {
+    bool completable = true;
+    for (size_t i = 0; i < Rules::MAX_LINE_SIZE && completable; ++i) {
+        if ((present & (1u << i)) == 0) {
+            size_t kind = sharesColour
+                ? shared * Rules::TYPES + i
+                : i * Rules::TYPES + shared;
+            completable = unseen[kind] + held[kind] > 0;
+        }
+    }
+
+    return completable;
+}
+
+template class BasicUnseenTiles<StandardRules>;
+template class BasicUnseenTiles<ExtendedRules>;
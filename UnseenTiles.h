@@ -0,0 +1,107 @@
+#ifndef UNSEEN_TILES_H
+#define UNSEEN_TILES_H
+
+#include "GameBoard.h"
+#include "PlayerHand.h"
+
+#include <array>
+#include <cstdint>
+
+using std::array;
+
+/**
+ * @note
+ * Tracks, from one player's point of view, how many copies of each tile kind
+ * have not been seen: every tile minus those on the board and in their own
+ * hand. The unseen tiles are the bag and the opponent's hand together, so the
+ * counts answer draw and line completion questions without looking at either.
+ * Every update and query by kind is O(1).
+ */
+template <class Rules>
+class BasicUnseenTiles {
+public:
+    /**
+     * Construct a tracker where every tile is unseen.
+     */
+    BasicUnseenTiles();
+
+    /**
+     * Recount from scratch, used when a game is dealt or loaded.
+     *
+     * @param board - the board
+     * @param hand - the player's own hand
+     */
+    void recount(const BasicGameBoard<Rules>& board,
+                 const BasicPlayerHand<Rules>& hand);
+
+    /**
+     * Record a tile placed on the board.
+     *
+     * @param tile - the tile placed
+     * @param fromOwnHand - whether this player placed it
+     */
+    void tilePlaced(const Tile& tile, bool fromOwnHand);
+
+    /**
+     * Record a tile drawn from the bag into this player's hand.
+     *
+     * @param tile - the tile drawn
+     */
+    void tileDrawn(const Tile& tile);
+
+    /**
+     * Record a tile returned from this player's hand to the bag.
+     *
+     * @param tile - the tile returned
+     */
+    void tileReturned(const Tile& tile);
+
+    /**
+     * Get the number of unseen copies of a kind.
+     *
+     * @param kind - the tile kind
+     */
+    size_t count(size_t kind) const;
+
+    /**
+     * Get the number of unseen tiles in total.
+     */
+    size_t total() const;
+
+    /**
+     * Get the probability that a tile drawn from the unseen tiles is of the
+     * given kind.
+     *
+     * @param kind - the tile kind
+     * @return the probability between 0 and 1
+     */
+    double drawProbability(size_t kind) const;
+
+    /**
+     * Query whether the given line could still be completed to a QWIRKLE
+     * with tiles that are not on the board.
+     *
+     * @param line - the tiles of the line
+     * @return true if every missing tile has a copy unseen or in hand
+     */
+    bool canCompleteQwirkle(const TileList& line) const;
+
+private:
+    /**
+     * Query whether every kind missing from a line sharing one attribute has
+     * a copy that is unseen or in hand.
+     *
+     * @param sharesColour - whether the line shares colour rather than shape
+     * @param shared - the index of the shared colour or shape
+     * @param present - a mask of the other attribute's indices in the line
+     */
+    bool canComplete(bool sharesColour, size_t shared, uint32_t present) const;
+
+    array<uint8_t, Rules::KINDS> unseen;
+    array<uint8_t, Rules::KINDS> held;
+    size_t unseenTotal;
+};
+
+typedef BasicUnseenTiles<StandardRules> UnseenTiles;
+
+#endif // !UNSEEN_TILES_H
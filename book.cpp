@@ -0,0 +1,95 @@
+#include "Bot.h"
+#include "OpeningBook.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+int main(int argc, char** argv) {
+    // usage: qwirkle-book [--tiles <count>] [--games <count>] [--bot <bot>]
+    //                     [--budget <ms>] [--seed <seed>]
+    //                     [--threads <count>] <file>
+    size_t tiles = 2;
+    size_t games = 10000;
+    string config = "greedy";
+    size_t budget = 100;
+    uint64_t seed = 1;
+    size_t threads = 0;
+    string fileName;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--tiles") == 0 && i + 1 < argc)
+            tiles = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+            games = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--bot") == 0 && i + 1 < argc)
+            config = argv[++i];
+        else if (strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budget = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::stoull(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::stoul(argv[++i]);
+        else
+            fileName = argv[i];
+    }
+
+    if (fileName.empty()) {
+        cerr << "Give the name of the book to write" << endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        // every first move, then the positions a bot's own games reach
+        OpeningBookBuilder builder(tiles);
+        builder.addOpenings();
+        cout << builder.getPositionCount() << " openings" << endl;
+
+        unique_ptr<Bot> bot = Bot::create(config);
+        GameManager manager;
+        mt19937_64 random(seed);
+        for (size_t game = 0; game < games; ++game) {
+            bool failed = false;
+            manager.listener = [&failed](const string& message, State state) {
+                failed = state == PLACE_FAILURE || state == REPLACE_FAILURE;
+            };
+            manager.beginGame("FIRST", "SECOND", seed + game);
+
+            while (manager.board->getIndex().getTileCount() <= tiles) {
+                builder.add(manager);
+                BotMove move = bot->choose(manager, random);
+                Tile tile(
+                    StandardRules::colourAt(move.kind / StandardRules::TYPES),
+                    StandardRules::shapeAt(move.kind % StandardRules::TYPES));
+                if (move.replace)
+                    manager.replaceTile(tile.getColour(), tile.getShape());
+                else
+                    manager.placeTile(tile.getColour(), tile.getShape(),
+                        move.row, move.column);
+                if (failed)
+                    break;
+            }
+            manager.resetGame();
+        }
+        cout << builder.getPositionCount() << " positions" << endl;
+
+        auto start = std::chrono::steady_clock::now();
+        builder.write(fileName, std::chrono::milliseconds(budget), threads);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        OpeningBook book(fileName);
+        cout << book.getEntryCount() << " positions searched into "
+             << fileName << " in " << elapsed.count() << " s" << endl;
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,71 @@
+#include "GameQuery.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+int main(int argc, char** argv) {
+    // usage: qwirkle-query [--threads <count>] [--player <name>]
+    //                      [--first <name>] [--second <name>]
+    //                      [--min-moves <count>] [--max-moves <count>]
+    //                      [--min-score <score>] [--heatmap] <archive>
+    size_t threads = 0;
+    QueryFilter filter;
+    bool heatmap = false;
+    string fileName;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--player") == 0 && i + 1 < argc)
+            filter.player = argv[++i];
+        else if (strcmp(argv[i], "--first") == 0 && i + 1 < argc)
+            filter.first = argv[++i];
+        else if (strcmp(argv[i], "--second") == 0 && i + 1 < argc)
+            filter.second = argv[++i];
+        else if (strcmp(argv[i], "--min-moves") == 0 && i + 1 < argc)
+            filter.minMoves = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--max-moves") == 0 && i + 1 < argc)
+            filter.maxMoves = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--min-score") == 0 && i + 1 < argc)
+            filter.minScore = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--heatmap") == 0)
+            heatmap = true;
+        else
+            fileName = argv[i];
+    }
+
+    if (fileName.empty()) {
+        cerr << "Give the name of the archive to query" << endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        ArchiveReader reader(fileName);
+        ArchiveQuery query(reader, filter);
+
+        auto start = std::chrono::steady_clock::now();
+        QueryTotals totals = query.run(threads);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        // the timing goes to cerr, so the totals alone are on cout
+        totals.print(cout, heatmap);
+        cerr << reader.getGameCount() << " games scanned in "
+             << std::fixed << std::setprecision(2) << elapsed.count()
+             << " s, " << std::setprecision(0)
+             << reader.getGameCount() / elapsed.count() << " games/s"
+             << endl;
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -2,8 +2,12 @@
 #include "TileCodes.h"
 #include "Constants.h"
 #include "IOHandler.h"
+#include "BotProtocol.h"
+#include "Stats.h"
 
+#include <cstring>
 #include <iostream>
+#include <string>
 
 using std::cout;
 using std::cin;
@@ -21,7 +25,45 @@ void testPlayerHand();
 // tests for GameBoard implementation
 void testGameBoard();
 
-int main(void) {
+int main(int argc, char** argv) {
+    // optional flags: --autosave <moves> [--autosave-file <name>]
+    //                 [--autosave-deltas] [--stats] [--bot] [--ansi]
+    //                 [--crop]
+    size_t autosaveInterval = 0;
+    bool autosaveDeltas = false;
+    bool botMode = false;
+    string autosaveFile = "autosave.save";
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--autosave") == 0 && i + 1 < argc)
+            autosaveInterval = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--autosave-file") == 0 && i + 1 < argc)
+            autosaveFile = argv[++i];
+        else if (strcmp(argv[i], "--autosave-deltas") == 0)
+            autosaveDeltas = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            Stats::dumpOnExit = true;
+        else if (strcmp(argv[i], "--bot") == 0)
+            botMode = true;
+        else if (strcmp(argv[i], "--ansi") == 0)
+            IOHandler::ansi = true;
+        else if (strcmp(argv[i], "--crop") == 0)
+            IOHandler::crop = true;
+    }
+
+    // programs play through the bot protocol, a response per request line
+    if (botMode) {
+        BotProtocol protocol;
+        string request;
+        while (!protocol.isFinished() && getline(cin, request))
+            cout << protocol.handle(request) << endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    if (autosaveInterval > 0)
+        IOHandler::enableAutosave(
+            autosaveFile, autosaveInterval, autosaveDeltas);
+
     // testLinkedList();
     // testTileBag();
     // testPlayerHand();
@@ -39,12 +81,15 @@ int main(void) {
             IOHandler::quit();
     }
 
+    if (Stats::dumpOnExit)
+        Stats::print(std::cerr);
+
     return EXIT_SUCCESS;
 }
 
 void testLinkedList() {
     cout << "testing linkedlist..." << endl;
-    shared_ptr<LinkedList> list = make_shared<LinkedList>();
+    shared_ptr<TileList> list = make_shared<TileList>();
 
     shared_ptr<Tile> tile1 = make_shared<Tile>(RED, CIRCLE);
     shared_ptr<Tile> tile2 = make_shared<Tile>(ORANGE, STAR_4);
@@ -94,8 +139,8 @@ void testLinkedList() {
     cout << *list << endl;
 
     cout << "testing if linkedlist contains tile..." << endl;
-    cout << "contains " << *tile7 << " - " << (list->contains(*tile7) ? "true" : "false") << endl;
-    cout << "contains " << *tile4 << " - " << (list->contains(*tile4) ? "true" : "false") << endl;
+    cout << "contains " << *tile7 << " - " << (list->containsIf([&tile7](const shared_ptr<Tile>& tile) { return *tile == *tile7; }) ? "true" : "false") << endl;
+    cout << "contains " << *tile4 << " - " << (list->containsIf([&tile4](const shared_ptr<Tile>& tile) { return *tile == *tile4; }) ? "true" : "false") << endl;
 
     cout << "testing if linkedlist is empty..." << endl;
     cout << "empty - " << (list->isEmpty() ? "true" : "false") << endl;
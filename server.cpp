@@ -0,0 +1,70 @@
+#include "GameServer.h"
+#include "Stats.h"
+
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <pthread.h>
+#include <unistd.h>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+int main(int argc, char** argv) {
+    // optional flags: [--socket <path> | --port <port>] [--loops <count>]
+    //                 [--saves <directory>] [--stats]
+    string socketPath = "qwirkle.sock";
+    string saveDirectory = "saves";
+    long port = -1;
+    size_t loops = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc)
+            socketPath = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            port = std::stol(argv[++i]);
+        else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc)
+            loops = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--saves") == 0 && i + 1 < argc)
+            saveDirectory = argv[++i];
+        else if (strcmp(argv[i], "--stats") == 0)
+            Stats::dumpOnExit = true;
+    }
+
+    // the event loops inherit the blocked signals, only main waits for them
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    try {
+        bool loopback = port >= 0;
+        int listener = loopback
+            ? GameServer::listenLoopback(port)
+            : GameServer::listenUnix(socketPath);
+
+        GameServer server(listener, loops, saveDirectory);
+        server.start();
+        cout << "Serving Qwirkle on "
+             << (loopback ? "127.0.0.1:" + std::to_string(port) : socketPath)
+             << endl;
+
+        int received;
+        sigwait(&signals, &received);
+        server.stop();
+
+        if (!loopback)
+            unlink(socketPath.c_str());
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    if (Stats::dumpOnExit)
+        Stats::print(cerr);
+
+    return EXIT_SUCCESS;
+}
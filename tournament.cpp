@@ -0,0 +1,90 @@
+#include "Tournament.h"
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using std::cerr;
+using std::cout;
+using std::endl;
+
+int main(int argc, char** argv) {
+    // usage: qwirkle-tournament [--games <per pairing>] [--seed <seed>]
+    //                           [--threads <count>] [--export <file>]
+    //                           [--archive <file>] [--book <file>]
+    //                           <bot> <bot>...
+    size_t games = 100;
+    uint64_t seed = 1;
+    size_t threads = 0;
+    string exportFile;
+    string archiveFile;
+    string bookFile;
+    vector<string> bots;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--games") == 0 && i + 1 < argc)
+            games = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = std::stoull(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = std::stoul(argv[++i]);
+        else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc)
+            exportFile = argv[++i];
+        else if (strcmp(argv[i], "--archive") == 0 && i + 1 < argc)
+            archiveFile = argv[++i];
+        else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc)
+            bookFile = argv[++i];
+        else
+            bots.push_back(argv[i]);
+    }
+
+    if (bots.size() < 2) {
+        cerr << "A tournament needs at least two bots: random, greedy or "
+                "search:<ms>" << endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        Tournament tournament(bots, games, seed);
+        shared_ptr<TrainingWriter> writer;
+        if (!exportFile.empty()) {
+            writer = std::make_shared<TrainingWriter>(exportFile);
+            tournament.exportTo(writer);
+        }
+        shared_ptr<ArchiveWriter> archive;
+        if (!archiveFile.empty()) {
+            archive = std::make_shared<ArchiveWriter>(archiveFile);
+            tournament.archiveTo(archive);
+        }
+        if (!bookFile.empty())
+            tournament.useBook(std::make_shared<OpeningBook>(bookFile));
+
+        auto start = std::chrono::steady_clock::now();
+        tournament.run(threads);
+        std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+
+        tournament.report(cout);
+        cout << endl << tournament.getGameCount() << " games in "
+             << std::fixed << std::setprecision(2) << elapsed.count()
+             << " s, " << std::setprecision(0)
+             << tournament.getGameCount() / elapsed.count() << " games/s"
+             << endl;
+        if (writer) {
+            cout << writer->getRecordCount() << " positions exported to "
+                 << exportFile << endl;
+        }
+        if (archive) {
+            archive->close();
+            cout << archive->getGameCount() << " games archived to "
+                 << archiveFile << endl;
+        }
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}